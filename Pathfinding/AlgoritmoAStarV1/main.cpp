@@ -6,14 +6,20 @@ original code from https://stackoverflow.com/questions/26210108/a-star-shortest-
 In computer science, A* (pronounced "A star") is a computer algorithm that is widely used in pathfinding and graph traversal, which is 
 the process of finding a path between multiple points, called "nodes". It enjoys widespread use due to its performance and accuracy. 
 However, in practical travel-routing systems, it is generally outperformed by algorithms which can pre-process the graph to attain 
-better performance, although other work has found A* to be superior to other approaches. */
+better performance, although other work has found A* to be superior to other approaches.
+
+The open list is a template parameter of pathFind. Run the program with the "benchmark" argument to compare the expanded nodes
+per second of every open list. */
 #include <istream>
 #include <iostream>
 #include <iomanip>
 #include <queue>
+#include <vector>
 #include <string>
+#include <algorithm>
 #include <math.h>
 #include <ctime>
+#include <chrono>
 using namespace std;
 
 #define mapWidth 60 // horizontal size of the map
@@ -22,6 +28,9 @@ static int map[mapWidth][mapHeight]; //grid
 static int closedNodesMap[mapWidth][mapHeight]; // map of closed (tried-out) nodes
 static int openNodesMap[mapWidth][mapHeight]; // map of open (not-yet-tried) nodes
 static int directionsMap[mapWidth][mapHeight]; // map of directions
+static int levelMap[mapWidth][mapHeight]; // map of G(n) of the reached nodes
+static unsigned int generationMap[mapWidth][mapHeight]; // search (generation) that wrote the Node maps of every location
+static unsigned int generation; // incremented by every pathFind call. the Node maps of older generations are reset lazily
 #define directions 8 // number of possible directions to go at any position. Using 4 directions increase speed.
 #if directions == 4
 static int dx[directions]={1, 0, -1, 0};
@@ -30,6 +39,8 @@ static int dy[directions]={0, 1, 0, -1};
 static int dx[directions] = {1, 1, 0, -1, -1, -1, 0, 1};
 static int dy[directions] = {0, 1, 1, 1, 0, -1, -1, -1};
 #endif // directions
+#define openList IndexedHeapOpenList // open list used by pathFind: TwoHeapOpenList, IndexedHeapOpenList or LazyHeapOpenList
+static long long expandedNodes; // nodes expanded by the last pathFind call
 static char tips[5] = {'.', 'O'/*obstacle*/, 'S'/*start*/, 'R'/*route*/, 'F'/*finish*/};
 static int x, y;
 
@@ -69,67 +80,220 @@ public:
 // Determine priority (in the priority queue)
 bool operator<(const Node& a, const Node& b) { return a.getPriority() > b.getPriority(); }
 
+/* the entry of an open list: the priority and the location index (y * mapWidth + x). The level and the parent direction of a Node
+live in levelMap and directionsMap, so pathFind does not allocate any Node and the heaps only move 8 bytes per entry */
+struct NodeKey
+{
+    int priority;
+    int index;
+};
+
+bool operator<(const NodeKey& a, const NodeKey& b) { return a.priority > b.priority; }
+
 int updateDirection(const int Value){ return (Value + directions / 2) % directions; }
 
+/* The open lists of NodeKey entries. All of them replace an already open Node by a cheaper one at the same location with 
+decreaseKey */
+
+// original open list: the Node is replaced by emptying one pq to the other one. O(n log n) per decreaseKey
+class TwoHeapOpenList
+{
+private:
+    priority_queue<NodeKey> pq[2];
+    int pqi = 0; // pq index
+public:
+    bool empty() const { return pq[pqi].empty(); }
+    const NodeKey& top() const { return pq[pqi].top(); }
+    void push(const NodeKey& Value) { pq[pqi].push(Value); }
+    void pop() { pq[pqi].pop(); }
+    void clear() { while (!pq[pqi].empty()) { pq[pqi].pop(); } }
+
+    void decreaseKey(const NodeKey& Value)
+    {
+        /* replace the Node by emptying one pq to the other one except the Node to be replaced will be ignored and the 
+		new Node will be pushed in instead */
+        const NodeKey& replaceNode = pq[pqi].top();
+        while (replaceNode.index != Value.index)
+        {
+            pq[1 - pqi].push(replaceNode);
+            pq[pqi].pop();
+        }
+        pq[pqi].pop(); // remove the wanted Node
+
+        // empty the larger size pq to the smaller one
+        if (pq[pqi].size() > pq[1 - pqi].size()) { pqi = 1 - pqi; }
+        while (!pq[pqi].empty())
+        {
+            pq[1 - pqi].push(pq[pqi].top());
+            pq[pqi].pop();
+        }
+        pqi = 1 - pqi;
+        pq[pqi].push(Value); // add the better Node instead
+    }
+};
+
+// indexed 4-ary heap. heapIndexMap keeps the heap slot of every open location, so decreaseKey only sifts the Node up. O(log n)
+class IndexedHeapOpenList
+{
+private:
+    vector<NodeKey> heap;
+    int heapIndexMap[mapWidth * mapHeight]; // map of heap slots (position-to-handle index)
+
+    void place(const NodeKey& Value, const int slot)
+    {
+        heap[slot] = Value;
+        heapIndexMap[Value.index] = slot;
+    }
+
+    void siftUp(int slot)
+    {
+        const NodeKey value = heap[slot];
+        while (slot > 0)
+        {
+            const int parent = (slot - 1) / 4;
+            if (heap[parent].priority <= value.priority) { break; }
+            place(heap[parent], slot);
+            slot = parent;
+        }
+        place(value, slot);
+    }
+
+    void siftDown(int slot)
+    {
+        const NodeKey value = heap[slot];
+        const int size = heap.size();
+        while (true)
+        {
+            const int firstChild = slot * 4 + 1;
+            if (firstChild >= size) { break; }
+            const int lastChild = min(firstChild + 4, size);
+            int best = firstChild;
+            for (int child = firstChild + 1; child < lastChild; ++child)
+            {
+                if (heap[child].priority < heap[best].priority) { best = child; }
+            }
+            if (heap[best].priority >= value.priority) { break; }
+            place(heap[best], slot);
+            slot = best;
+        }
+        place(value, slot);
+    }
+public:
+    bool empty() const { return heap.empty(); }
+    const NodeKey& top() const { return heap.front(); }
+    void push(const NodeKey& Value) { heap.push_back(Value); siftUp(heap.size() - 1); }
+    void clear() { heap.clear(); }
+
+    void pop()
+    {
+        heap.front() = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) { siftDown(0); }
+    }
+
+    void decreaseKey(const NodeKey& Value)
+    {
+        const int slot = heapIndexMap[Value.index];
+        heap[slot] = Value;
+        siftUp(slot);
+    }
+};
+
+/* lazy deletion: decreaseKey pushes a duplicate Node and the old one stays in the pq. A Node is stale when its location is already
+closed or when openNodesMap holds a better priority for it, and stale nodes are skipped when they reach the top */
+class LazyHeapOpenList
+{
+private:
+    priority_queue<NodeKey> pq;
+
+    void skipStaleNodes()
+    {
+        while (!pq.empty())
+        {
+            const NodeKey& first = pq.top();
+            const int xFirst = first.index % mapWidth;
+            const int yFirst = first.index / mapWidth;
+            if (closedNodesMap[xFirst][yFirst] == 0 && openNodesMap[xFirst][yFirst] == first.priority) { break; }
+            pq.pop();
+        }
+    }
+public:
+    bool empty() { skipStaleNodes(); return pq.empty(); }
+    const NodeKey& top() { skipStaleNodes(); return pq.top(); }
+    void push(const NodeKey& Value) { pq.push(Value); }
+    void pop() { pq.pop(); }
+    void clear() { while (!pq.empty()) { pq.pop(); } }
+    void decreaseKey(const NodeKey& Value) { pq.push(Value); }
+};
+
+// clear the Node maps of a location the first time the current search touches it
+inline void touchNode(const int x, const int y)
+{
+    if (generationMap[x][y] != generation)
+    {
+        generationMap[x][y] = generation;
+        closedNodesMap[x][y] = 0;
+        openNodesMap[x][y] = 0;
+    }
+}
+
 // A-star algorithm. // The route returned is a string of direction digits.
+template<class OpenList>
 string pathFind(const int xStart, const int yStart, const int xFinish, const int yFinish)
 {
-    static priority_queue<Node> pq[2]; // list of open (not-yet-tried) nodes
-    static int pqi; // pq index
-    static Node* n0;
-    static Node* m0;
-    static int i, j, xdx, ydy;
+    static OpenList openNodes; // list of open (not-yet-tried) nodes
+    static int i, j, xdx, ydy, level;
     static char c;
-    pqi = 0;
+    expandedNodes = 0;
 
-    // reset the Node maps
-    for (y = 0; y < mapHeight; ++y)
+    // start a new generation instead of resetting the Node maps. they are only cleared when the counter wraps around
+    if (++generation == 0)
     {
-        for (x = 0; x < mapWidth; ++x)
+        for (y = 0; y < mapHeight; ++y)
         {
-            closedNodesMap[x][y] = 0;
-            openNodesMap[x][y] = 0;
+            for (x = 0; x < mapWidth; ++x) { generationMap[x][y] = 0; }
         }
+        generation = 1;
     }
 
-    // create the start Node and push into list of open nodes
-    n0 = new Node(xStart, yStart, 0, 0);
-    n0->updatePriority(xFinish, yFinish);
-    pq[pqi].push(*n0);
-    openNodesMap[x][y] = n0->getPriority(); // mark it on the open nodes map
+    // create the start Node and push into list of open nodes. the Node lives on the stack, its data is kept in the node maps
+    Node n0(xStart, yStart, 0, 0);
+    n0.updatePriority(xFinish, yFinish);
+    touchNode(xStart, yStart);
+    levelMap[xStart][yStart] = 0;
+    openNodesMap[xStart][yStart] = n0.getPriority(); // mark it on the open nodes map
+    openNodes.push(NodeKey{n0.getPriority(), yStart * mapWidth + xStart});
 
     // A* search
-    while (!pq[pqi].empty())
+    while (!openNodes.empty())
     {
         // get the current Node w/ the highest priority from the list of open nodes
-        const Node& currentNode = pq[pqi].top();
-        n0 = new Node(currentNode.getxPos(), currentNode.getyPos(), currentNode.getLevel(), currentNode.getPriority());
-
-        x = n0->getxPos();
-        y = n0->getyPos();
+        x = openNodes.top().index % mapWidth;
+        y = openNodes.top().index / mapWidth;
+        level = levelMap[x][y];
 
-        pq[pqi].pop(); // remove the Node from the open list
+        openNodes.pop(); // remove the Node from the open list
         openNodesMap[x][y] = 0;
         closedNodesMap[x][y] = 1; // mark it on the closed nodes map
+        ++expandedNodes;
 
         // quit searching when the goal state is reached
-        //if((*n0).estimate(xFinish, yFinish) == 0)
         if (x == xFinish && y == yFinish)
         {
-            // generate the path from finish to start by following the directions
+            // generate the path from finish to start by following the directions, and reverse it
             string path = "";
+            path.reserve(levelMap[x][y] / 10 + 1); // every step adds 10 or 14 to the level
             while (!(x == xStart && y == yStart))
             {
                 j = directionsMap[x][y];
                 c = '0' + updateDirection(j);
-                path = c + path;
+                path += c;
                 x += dx[j];
                 y += dy[j];
             }
+            reverse(path.begin(), path.end());
 
-            delete n0; // garbage collection
-            // empty the leftover nodes
-            while (!pq[pqi].empty()) { pq[pqi].pop(); }
+            openNodes.clear(); // empty the leftover nodes
             return path;
         }
 
@@ -139,57 +303,93 @@ string pathFind(const int xStart, const int yStart, const int xFinish, const int
             xdx = x + dx[i];
             ydy = y + dy[i];
 
-            if (!(xdx < 0 || xdx > mapWidth - 1 || ydy < 0 || ydy > mapHeight - 1 || map[xdx][ydy] == 1 
-				|| closedNodesMap[xdx][ydy] == 1))
+            if (xdx < 0 || xdx > mapWidth - 1 || ydy < 0 || ydy > mapHeight - 1 || map[xdx][ydy] == 1) { continue; }
+            touchNode(xdx, ydy);
+            if (closedNodesMap[xdx][ydy] == 0)
             {
-                m0 = new Node(xdx, ydy, n0->getLevel(), n0->getPriority()); // generate a child Node
-                m0->nextLevel(i);
-                m0->updatePriority(xFinish, yFinish);
+                Node m0(xdx, ydy, level, 0); // generate a child Node
+                m0.nextLevel(i);
+                m0.updatePriority(xFinish, yFinish);
 
                 // if it is not in the open list then add into that
                 int& openNode = openNodesMap[xdx][ydy];
                 int& direction = directionsMap[xdx][ydy];
-                const int& m0Priority = m0->getPriority();
+                const int m0Priority = m0.getPriority();
                 if (openNode == 0)
                 {
                     openNode = m0Priority; // update the priority info
-                    pq[pqi].push(*m0);
+                    levelMap[xdx][ydy] = m0.getLevel();
+                    openNodes.push(NodeKey{m0Priority, ydy * mapWidth + xdx});
                     direction = updateDirection(i); // mark its parent Node direction
                 }
                 else if (openNode > m0Priority)
                 {
                     openNode = m0Priority; // update the priority info
+                    levelMap[xdx][ydy] = m0.getLevel();
                     direction = updateDirection(i); // update the parent direction info
-
-                    /* replace the Node by emptying one pq to the other one except the Node to be replaced will be ignored and the 
-					new Node will be pushed in instead */
-                    const Node& replaceNode = pq[pqi].top();
-                    while (!(replaceNode.getxPos() == xdx && replaceNode.getyPos() == ydy))
-                    {
-                        pq[1 - pqi].push(replaceNode);
-                        pq[pqi].pop();
-                    }
-                    pq[pqi].pop(); // remove the wanted Node
-
-                    // empty the larger size pq to the smaller one
-                    if (pq[pqi].size() > pq[1 - pqi].size()) { pqi = 1 - pqi; }
-                    while (!pq[pqi].empty())
-                    {
-                        pq[1 - pqi].push(pq[pqi].top());
-                        pq[pqi].pop();
-                    }
-                    pqi = 1 - pqi;
-                    pq[pqi].push(*m0); // add the better Node instead
+                    openNodes.decreaseKey(NodeKey{m0Priority, ydy * mapWidth + xdx}); // replace the open Node by the better one
                 }
-                else { delete m0; } // garbage collection
             }
         }
-        delete n0; // garbage collection
     }
     return ""; // no route found
 }
 
-int main()
+string pathFind(const int xStart, const int yStart, const int xFinish, const int yFinish)
+{
+    return pathFind<openList>(xStart, yStart, xFinish, yFinish);
+}
+
+// the start and finish locations used by main. RouteCase goes from 0 to 7
+void selectRoute(const int RouteCase, int& xA, int& yA, int& xB, int& yB)
+{
+    switch (RouteCase)
+    {
+        case 0: xA = 0; yA = 0; xB = mapWidth - 1; yB = mapHeight - 1; break;
+        case 1: xA = 0; yA = mapHeight - 1; xB = mapWidth - 1; yB = 0; break;
+        case 2: xA = mapWidth / 2 - 1; yA = mapHeight / 2 - 1; xB = mapWidth / 2 + 1; yB = mapHeight / 2 + 1; break;
+        case 3: xA = mapWidth / 2 - 1; yA = mapHeight / 2 + 1; xB = mapWidth / 2 + 1; yB = mapHeight / 2 - 1; break;
+        case 4: xA = mapWidth / 2 - 1; yA = 0; xB = mapWidth / 2 + 1; yB = mapHeight - 1; break;
+        case 5: xA = mapWidth / 2 + 1; yA = mapHeight - 1; xB = mapWidth / 2 - 1; yB = 0; break;
+        case 6: xA = 0; yA = mapHeight / 2 - 1; xB = mapWidth - 1; yB = mapHeight / 2 + 1; break;
+        case 7: xA = mapWidth - 1; yA = mapHeight / 2 + 1; xB = 0; yB = mapHeight / 2 - 1; break;
+    }
+}
+
+// solve every route case many times and print the expanded nodes per second of an open list
+template<class OpenList>
+void benchmarkOpenList(const char* Name, const int Repetitions)
+{
+    int xA = 0, yA = 0, xB = 0, yB = 0;
+    long long expansions = 0, routesCost = 0;
+    const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int r = 0; r < Repetitions; ++r)
+    {
+        for (int routeCase = 0; routeCase < 8; ++routeCase)
+        {
+            selectRoute(routeCase, xA, yA, xB, yB);
+            const string route = pathFind<OpenList>(xA, yA, xB, yB);
+            for (const char c : route) { routesCost += (directions == 8 && (c - '0') % 2 == 1 ? 14 : 10); }
+            expansions += expandedNodes;
+        }
+    }
+    const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << setw(20) << left << Name << right << setw(12) << expansions << setw(12) << fixed << setprecision(3) << seconds 
+        << setw(16) << setprecision(0) << expansions / seconds << setw(12) << routesCost << endl;
+}
+
+void runBenchmark()
+{
+    const int repetitions = 50;
+    cout << "Open list benchmark. " << repetitions << " x 8 routes on the " << mapWidth << "x" << mapHeight << " map" << endl;
+    cout << setw(20) << left << "Open list" << right << setw(12) << "Expansions" << setw(12) << "Seconds" << setw(16) 
+        << "Expansions/s" << setw(12) << "Routes cost" << endl;
+    benchmarkOpenList<TwoHeapOpenList>("TwoHeapOpenList", repetitions);
+    benchmarkOpenList<IndexedHeapOpenList>("IndexedHeapOpenList", repetitions);
+    benchmarkOpenList<LazyHeapOpenList>("LazyHeapOpenList", repetitions);
+}
+
+int main(int argc, char* argv[])
 {
     srand(time(0));
 
@@ -209,20 +409,16 @@ int main()
     for (x = xn; x < nn; ++x) { map[x][xMapHeight] = 1; }
     for (y = xm; y < mm; ++y) { map[xMapWidth][y] = 1; }
 
-    // randomly select start and finish locations
-    int xA, yA, xB, yB;
-    switch (rand() % 8)
+    if (argc > 1 && string(argv[1]) == "benchmark")
     {
-        case 0: xA = 0; yA = 0; xB = mapWidth - 1; yB = mapHeight - 1; break;
-        case 1: xA = 0; yA = mapHeight - 1; xB = mapWidth - 1; yB = 0; break;
-        case 2: xA = mapWidth / 2 - 1; yA = mapHeight / 2 - 1; xB = mapWidth / 2 + 1; yB = mapHeight / 2 + 1; break;
-        case 3: xA = mapWidth / 2 - 1; yA = mapHeight / 2 + 1; xB = mapWidth / 2 + 1; yB = mapHeight / 2 - 1; break;
-        case 4: xA = mapWidth / 2 - 1; yA = 0; xB = mapWidth / 2 + 1; yB = mapHeight - 1; break;
-        case 5: xA = mapWidth / 2 + 1; yA = mapHeight - 1; xB = mapWidth / 2 - 1; yB = 0; break;
-        case 6: xA = 0; yA = mapHeight / 2 - 1; xB = mapWidth - 1; yB = mapHeight / 2 + 1; break;
-        case 7: xA = mapWidth - 1; yA = mapHeight / 2 + 1; xB = 0; yB = mapHeight / 2 - 1; break;
+        runBenchmark();
+        return 0;
     }
 
+    // randomly select start and finish locations
+    int xA = 0, yA = 0, xB = 0, yB = 0;
+    selectRoute(rand() % 8, xA, yA, xB, yB);
+
     cout << "Using " << directions << " directions" << endl;
     cout << "Map Size (X,Y): " << mapWidth << "," << mapHeight << endl;
     cout << "Start: " << xA << "," << yA << endl;
@@ -0,0 +1,175 @@
+/**
+Lazy Theta*: any-angle routes on the grid. http://idm-lab.org/bib/abstracts/papers/aaai10b.pdf
+A* only moves in the 8 directions of dx/dy, so its routes zig-zag. Theta* lets the parent of a Node be any cell in line of sight,
+not only a neighbour: a child reached from n0 takes the parent of n0 as its own parent when the straight line between them is free,
+so the routes are straight lines between a few corners (the waypoints). Lazy Theta* does not test the line of sight when a child is
+generated: it assumes it, and tests it once when the Node is expanded. When the line is blocked, the parent is the best closed
+neighbour instead, as in A*. So there is one line of sight test per expanded Node instead of one per generated one.
+The lines of sight are the integer Bresenham lines of GridMap::hasLineOfSight, which follow the moves of the grid (a diagonal can go
+between two obstacles touching by a corner). So the route of cells between two waypoints (toRoute) is always a valid grid route.
+A line between two waypoints costs 10 times its length, rounded, and the estimate is the straight distance to the finish. The
+routes are not always the shortest any-angle ones, but they are usually shorter than the routes of the 8 directions. */
+
+#ifndef _ANYANGLEPATHFINDER_
+#define _ANYANGLEPATHFINDER_
+
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include "GridMap.h"
+#include "Node.h"
+#include "Route.h"
+#include "OpenList.h"
+#include "GenerationMap.h"
+
+// the cost of a straight line, 10 per cell of length. the 10/14 moves of the grid cost about the same
+inline int lineCost(const int xd, const int yd) { return static_cast<int>(std::lround(10.0 * std::sqrt(xd * xd + yd * yd))); }
+
+class AnyAnglePathFinder {
+    static_assert(directions == 8, "Theta* needs 8 directions");
+private:
+    const GridMap& map;
+    std::vector<int> levelMap; // G(n) of the reached nodes
+    std::vector<int> parentMap; // map of the parent nodes (flattened index), any cell in line of sight
+    std::vector<unsigned char> closedNodesMap; // map of closed (tried-out) nodes
+    GenerationMap nodeGenerations; // cells of the node maps written by the current search
+    IndexedHeapOpenList openNodes; // list of open (not-yet-tried) nodes
+    long long expandedNodes = 0; // nodes expanded by the last pathFind call
+    long long lineOfSightChecks = 0; // lines of sight tested by the last pathFind call
+    long long firstHeapOperations = 0;
+    int routeCost = 0; // cost of the last route
+
+    // the straight distance to the finish, truncated so it does not overestimate lineCost
+    static int estimate(const int x, const int y, const Position2D& Finish) {
+        const int xd = Finish.xPos - x, yd = Finish.yPos - y;
+        return static_cast<int>(10.0 * std::sqrt(xd * xd + yd * yd));
+    }
+
+    // Lazy Theta* SetVertex: test the line of sight to the assumed parent, or take the best closed neighbour as the parent
+    void setVertex(const int index) {
+        const int mapWidth = map.getWidth();
+        const int x = index % mapWidth, y = index / mapWidth;
+        const int parent = parentMap[index];
+        ++lineOfSightChecks;
+        if(map.hasLineOfSight(parent % mapWidth, parent / mapWidth, x, y)) { return; }
+
+        int& level = levelMap[index];
+        level = -1;
+        for(unsigned int moves = getFreeDirections(map.getNeighbourhood(x, y)); moves != 0; moves &= moves - 1) {
+            const int i = lowestBit(moves);
+            const int neighbour = map.getIndex(x + dx[i], y + dy[i]);
+            if(!nodeGenerations.isCurrent(neighbour) || closedNodesMap[neighbour] == 0) { continue; }
+            const int neighbourLevel = levelMap[neighbour] + (i % 2 == 0 ? 10 : 14);
+            if(level == -1 || neighbourLevel < level) {
+                level = neighbourLevel;
+                parentMap[index] = neighbour;
+            }
+        }
+    }
+public:
+    explicit AnyAnglePathFinder(const GridMap& Map)
+        : map(Map), levelMap(Map.getSize()), parentMap(Map.getSize()), closedNodesMap(Map.getSize()) {
+        openNodes.resize(Map.getWidth(), Map.getHeight());
+        nodeGenerations.resize(Map.getSize());
+    }
+
+    const GridMap& getMap() const { return map; }
+    long long getExpandedNodes() const { return expandedNodes; }
+    long long getHeapOperations() const { return openNodes.getOperations() - firstHeapOperations; }
+    long long getLineOfSightChecks() const { return lineOfSightChecks; }
+    int getCost() const { return routeCost; } // the cost of the last route of waypoints
+
+    // the route as its corners, from the start to the finish. empty if not found, only the start when it is the finish
+    std::vector<Position2D> findWaypoints(const Position2D& Start, const Position2D& Finish) {
+        const int mapWidth = map.getWidth();
+        expandedNodes = 0;
+        lineOfSightChecks = 0;
+        firstHeapOperations = openNodes.getOperations();
+        routeCost = 0;
+        nodeGenerations.nextGeneration();
+
+        const int startIndex = map.getIndex(Start);
+        const int finishIndex = map.getIndex(Finish);
+        nodeGenerations.touch(startIndex);
+        closedNodesMap[startIndex] = 0;
+        levelMap[startIndex] = 0;
+        parentMap[startIndex] = startIndex;
+        openNodes.push(NodeKey{estimate(Start.xPos, Start.yPos, Finish), startIndex});
+
+        while(!openNodes.empty()) {
+            const int n0Index = openNodes.top().index;
+            openNodes.pop();
+            if(n0Index != startIndex) { setVertex(n0Index); }
+            closedNodesMap[n0Index] = 1;
+            ++expandedNodes;
+
+            if(n0Index == finishIndex) {
+                // the waypoints from the finish back to the start, reversed
+                std::vector<Position2D> waypoints;
+                routeCost = levelMap[finishIndex];
+                for(int index = finishIndex; ; index = parentMap[index]) {
+                    waypoints.push_back(Position2D(index % mapWidth, index / mapWidth));
+                    if(index == startIndex) { break; }
+                }
+                std::reverse(waypoints.begin(), waypoints.end());
+                openNodes.clear();
+                return waypoints;
+            }
+
+            // the children take the parent of n0, assuming the line of sight. setVertex tests it when they are expanded
+            const int x = n0Index % mapWidth, y = n0Index / mapWidth;
+            const int parent = parentMap[n0Index];
+            const int xParent = parent % mapWidth, yParent = parent / mapWidth;
+            for(unsigned int moves = getFreeDirections(map.getNeighbourhood(x, y)); moves != 0; moves &= moves - 1) {
+                const int i = lowestBit(moves);
+                const int xdx = x + dx[i], ydy = y + dy[i];
+                const int childIndex = map.getIndex(xdx, ydy);
+                const bool reached = !nodeGenerations.touch(childIndex);
+                if(!reached) { closedNodesMap[childIndex] = 0; }
+                else if(closedNodesMap[childIndex] == 1) { continue; }
+
+                const int m0Level = levelMap[parent] + lineCost(xdx - xParent, ydy - yParent);
+                if(reached && levelMap[childIndex] <= m0Level) { continue; }
+                levelMap[childIndex] = m0Level;
+                parentMap[childIndex] = parent;
+                const NodeKey m0{m0Level + estimate(xdx, ydy, Finish), childIndex};
+                if(reached) { openNodes.decreaseKey(m0); }
+                else { openNodes.push(m0); }
+            }
+        }
+        return std::vector<Position2D>(); // no route found
+    }
+
+    // the cells of a route of waypoints, walking the Bresenham line between every two of them
+    static Route toRoute(const std::vector<Position2D>& Waypoints) {
+        Route path;
+        for(size_t w = 1; w < Waypoints.size(); ++w) {
+            int x = Waypoints[w - 1].xPos, y = Waypoints[w - 1].yPos;
+            const int x1 = Waypoints[w].xPos, y1 = Waypoints[w].yPos;
+            const int xd = std::abs(x1 - x), yd = -std::abs(y1 - y);
+            const int xs = x < x1 ? 1 : -1, ys = y < y1 ? 1 : -1;
+            for(int error = xd + yd; x != x1 || y != y1; ) {
+                const int error2 = 2 * error;
+                int xm = 0, ym = 0;
+                if(error2 >= yd) { error += yd; xm = xs; }
+                if(error2 <= xd) { error += xd; ym = ys; }
+                x += xm;
+                y += ym;
+                for(int i = 0; i < directions; ++i) {
+                    if(dx[i] == xm && dy[i] == ym) { path.append(i); }
+                }
+            }
+        }
+        return path;
+    }
+
+    // the route in the cells form of the other pathfinders
+    Route findRoute(const Position2D& Start, const Position2D& Finish) { return toRoute(findWaypoints(Start, Finish)); }
+
+    // the route as a string of direction digits
+    std::string pathFind(const Position2D& Start, const Position2D& Finish) { return findRoute(Start, Finish).toString(); }
+};
+
+#endif // _ANYANGLEPATHFINDER_
@@ -0,0 +1,218 @@
+/**
+Anytime Repairing A* (ARA*). http://www.cs.cmu.edu/~maxim/files/ara_nips03.pdf
+The first route is searched with a weighted heuristic, F(n) = G(n) + W * H(n), which finds a route quickly and costs at most W
+times the optimal one. Then W is decreased and the route improved until the deadline of the query, or until it is optimal (W = 1).
+Every improvement reuses the G(n) of the last one: only the open nodes and the inconsistent ones (their G(n) was lowered after they
+were closed) are searched again, instead of starting from scratch.
+The weights are kept in tenths (30 = 3.0), so the priorities stay integer: 10 * G(n) + W * H(n). getBound is the suboptimality
+bound proved for the returned route (its cost is at most getBound() times the optimal one), it can be lower than the last W.
+The deadline is checked every few expansions, so the search can end a bit after it. */
+
+#ifndef _ANYTIMEPATHFINDER_
+#define _ANYTIMEPATHFINDER_
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include "GridMap.h"
+#include "Node.h"
+#include "Route.h"
+#include "OpenList.h"
+#include "GenerationMap.h"
+#include "Heuristics.h"
+
+template<class Heuristic = OctileHeuristic, class Connectivity = defaultConnectivity>
+class AnytimePathFinder {
+private:
+    typedef std::chrono::steady_clock clock;
+    static const int checkInterval = 64; // expansions between two checks of the deadline
+
+    const GridMap& map;
+    std::vector<int> closedNodesMap; // iteration which closed the node. 0: not closed by this query
+    std::vector<int> openNodesMap; // priority of the open nodes. 0: not open
+    std::vector<int> levelMap; // map of G(n) of the reached nodes. -1: not reached
+    std::vector<unsigned char> directionsMap; // map of directions
+    std::vector<unsigned char> inconsistentMap; // the node is in inconsistentNodes
+    std::vector<int> inconsistentNodes; // closed nodes whose G(n) was lowered in the current iteration
+    std::vector<int> pendingNodes; // open and inconsistent nodes between two iterations
+    GenerationMap nodeGenerations; // cells of the node maps written by the current query
+    IndexedHeapOpenList openNodes; // list of open (not-yet-tried) nodes
+    Heuristic heuristic;
+    const int firstWeight, weightStep; // in tenths
+    int weight = 10; // weight of the current iteration, in tenths
+    int iteration = 0; // iterations (searches with a weight) of the last query
+    clock::duration timeBudget = clock::duration::zero(); // of findRoute without a deadline. zero: no limit
+    double bound = 0.0; // suboptimality bound of the last route. 0: no route
+    long long expandedNodes = 0; // nodes expanded by the last query, in all its iterations
+    long long firstHeapOperations = 0; // operations of the open list before the last query
+
+    void touchNode(const int index) {
+        if(nodeGenerations.touch(index)) {
+            closedNodesMap[index] = 0;
+            openNodesMap[index] = 0;
+            levelMap[index] = -1;
+            inconsistentMap[index] = 0;
+        }
+    }
+
+    int getPriority(const int index) const {
+        const int width = map.getWidth();
+        return 10 * levelMap[index] + weight * heuristic.estimate(index % width, index / width);
+    }
+
+    // search with the current weight until the finish has the best priority. false when the deadline ends it first
+    bool improveRoute(const int FinishIndex, const clock::time_point& Deadline) {
+        const int mapWidth = map.getWidth();
+        ++iteration;
+        while(!openNodes.empty()) {
+            if(levelMap[FinishIndex] != -1 && nodeGenerations.isCurrent(FinishIndex)
+                && 10 * levelMap[FinishIndex] <= openNodes.top().priority) {
+                return true;
+            }
+            if(expandedNodes % checkInterval == 0 && clock::now() >= Deadline) { return false; }
+
+            const int n0Index = openNodes.top().index;
+            const int x = n0Index % mapWidth;
+            const int y = n0Index / mapWidth;
+            const int n0Level = levelMap[n0Index];
+            openNodes.pop();
+            openNodesMap[n0Index] = 0;
+            closedNodesMap[n0Index] = iteration;
+            ++expandedNodes;
+
+            for(int i = 0; i < directions; i += Connectivity::step) {
+                const int xdx = x + dx[i];
+                const int ydy = y + dy[i];
+                if(!map.isInside(xdx, ydy) || map.isObstacle(xdx, ydy)) { continue; }
+                const int childIndex = map.getIndex(xdx, ydy);
+                touchNode(childIndex);
+                const int m0Level = n0Level + Connectivity::stepCost(i);
+                if(levelMap[childIndex] != -1 && levelMap[childIndex] <= m0Level) { continue; }
+                levelMap[childIndex] = m0Level;
+                directionsMap[childIndex] = reverseDirection(i);
+
+                if(closedNodesMap[childIndex] != iteration) {
+                    const int m0Priority = getPriority(childIndex);
+                    if(openNodesMap[childIndex] == 0) { openNodes.push(NodeKey{m0Priority, childIndex}); }
+                    else { openNodes.decreaseKey(NodeKey{m0Priority, childIndex}); }
+                    openNodesMap[childIndex] = m0Priority;
+                }
+                else if(inconsistentMap[childIndex] == 0) {
+                    // closed in this iteration: it is searched again in the next one
+                    inconsistentMap[childIndex] = 1;
+                    inconsistentNodes.push_back(childIndex);
+                }
+            }
+        }
+        return true;
+    }
+
+    // move the open and the inconsistent nodes to pendingNodes. the lowest G(n) + H(n) of them, -1 if there are none
+    int takePendingNodes() {
+        const int width = map.getWidth();
+        pendingNodes.clear();
+        while(!openNodes.empty()) {
+            pendingNodes.push_back(openNodes.top().index);
+            openNodesMap[openNodes.top().index] = 0;
+            openNodes.pop();
+        }
+        for(const int index : inconsistentNodes) {
+            inconsistentMap[index] = 0;
+            pendingNodes.push_back(index);
+        }
+        inconsistentNodes.clear();
+
+        int lowest = -1;
+        for(const int index : pendingNodes) {
+            const int estimate = levelMap[index] + heuristic.estimate(index % width, index / width);
+            if(lowest == -1 || estimate < lowest) { lowest = estimate; }
+        }
+        return lowest;
+    }
+public:
+    // FirstWeight and WeightStep are in tenths: the first route is searched with W = 3.0 and W is lowered by 0.5 every iteration
+    explicit AnytimePathFinder(const GridMap& Map, const int FirstWeight = 30, const int WeightStep = 5,
+        const Heuristic& Estimate = Heuristic())
+        : map(Map), closedNodesMap(Map.getSize()), openNodesMap(Map.getSize()), levelMap(Map.getSize()),
+        directionsMap(Map.getSize()), inconsistentMap(Map.getSize()), heuristic(Estimate), firstWeight(std::max(FirstWeight, 10)),
+        weightStep(std::max(WeightStep, 1)) {
+        openNodes.resize(Map.getWidth(), Map.getHeight());
+        nodeGenerations.resize(Map.getSize());
+    }
+
+    const GridMap& getMap() const { return map; }
+    long long getExpandedNodes() const { return expandedNodes; }
+    long long getHeapOperations() const { return openNodes.getOperations() - firstHeapOperations; }
+    int getIterations() const { return iteration; }
+    double getBound() const { return bound; }
+
+    // time of every findRoute call without a deadline. zero: search until the route is optimal
+    template<class Duration>
+    void setTimeBudget(const Duration& Budget) { timeBudget = std::chrono::duration_cast<clock::duration>(Budget); }
+
+    // the best route found before the deadline. empty if there is no route or the deadline ends the first iteration
+    Route findRoute(const Position2D& Start, const Position2D& Finish, const clock::time_point& Deadline) {
+        expandedNodes = 0;
+        firstHeapOperations = openNodes.getOperations();
+        iteration = 0;
+        bound = 0.0;
+        weight = firstWeight;
+        openNodes.clear();
+        inconsistentNodes.clear();
+        nodeGenerations.nextGeneration();
+        heuristic.setFinish(Finish);
+
+        const int startIndex = map.getIndex(Start);
+        const int finishIndex = map.getIndex(Finish);
+        touchNode(startIndex);
+        levelMap[startIndex] = 0;
+        const int startPriority = getPriority(startIndex);
+        openNodesMap[startIndex] = startPriority;
+        openNodes.push(NodeKey{startPriority, startIndex});
+
+        Route path;
+        while(improveRoute(finishIndex, Deadline)) {
+            if(levelMap[finishIndex] == -1 || !nodeGenerations.isCurrent(finishIndex)) { break; } // no route
+
+            // the route of this iteration, from the finish following the directions
+            path.clear();
+            int x = Finish.xPos;
+            int y = Finish.yPos;
+            while(!(x == Start.xPos && y == Start.yPos)) {
+                const int j = directionsMap[map.getIndex(x, y)];
+                path.append(reverseDirection(j));
+                x += dx[j];
+                y += dy[j];
+            }
+            path.reverse();
+
+            // no pending node can lead to a cheaper route than G(finish) / min(G(n) + H(n)) times
+            const int lowest = takePendingNodes();
+            const double proved = lowest > 0 ? static_cast<double>(levelMap[finishIndex]) / lowest : 1.0;
+            bound = std::max(1.0, std::min(weight / 10.0, proved));
+            if(bound == 1.0 || clock::now() >= Deadline) { break; }
+
+            // next iteration: lower weight, the pending nodes are open again and no node is closed
+            weight = std::max(weight - weightStep, 10);
+            for(const int index : pendingNodes) {
+                const int priority = getPriority(index);
+                openNodesMap[index] = priority;
+                openNodes.push(NodeKey{priority, index});
+            }
+        }
+        openNodes.clear(); // empty the leftover nodes
+        return path;
+    }
+
+    // findRoute with the time budget of setTimeBudget
+    Route findRoute(const Position2D& Start, const Position2D& Finish) {
+        const clock::time_point deadline = timeBudget == clock::duration::zero() ? clock::time_point::max() : clock::now() + timeBudget;
+        return findRoute(Start, Finish, deadline);
+    }
+
+    // the route as a string of direction digits
+    std::string pathFind(const Position2D& Start, const Position2D& Finish) { return findRoute(Start, Finish).toString(); }
+};
+
+#endif // _ANYTIMEPATHFINDER_
@@ -0,0 +1,117 @@
+/**
+BatchPathFinder: solves many (start, finish) queries at once with a pool of worker threads (compile with -pthread).
+Every worker owns its own pathfinder, so the node maps and the open list (the scratch buffers) are never shared, and all of them
+read the same GridMap, which must not change while a batch runs. The workers take small chunks of queries from an atomic counter
+and write every route at the index of its query, so the result does not depend on the number of threads or on their timing. */
+
+#ifndef _BATCHPATHFINDER_
+#define _BATCHPATHFINDER_
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <algorithm>
+#include "GridMap.h"
+#include "PathFinder.h"
+
+template<class Finder = PathFinder<> >
+class BatchPathFinder {
+private:
+    static const int chunkSize = 8; // queries taken by a worker at a time
+
+    const GridMap& map;
+    std::vector<std::unique_ptr<Finder> > finders; // one pathfinder (scratch buffers) per worker
+    std::vector<long long> expandedNodes; // per worker, nodes expanded in the last batch
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wakeUp, batchDone;
+    const std::vector<std::pair<Position2D, Position2D> >* queries = nullptr;
+    std::vector<std::string>* routes = nullptr;
+    std::atomic<size_t> nextQuery;
+    int runningWorkers = 0;
+    unsigned int batch = 0; // incremented for every batch, the workers wait for a new value
+    bool stopping = false;
+
+    void workerLoop(const int worker) {
+        unsigned int lastBatch = 0;
+        while(true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wakeUp.wait(lock, [&]() { return stopping || batch != lastBatch; });
+                if(stopping) { return; }
+                lastBatch = batch;
+            }
+
+            Finder& finder = *finders[worker];
+            const size_t size = queries->size();
+            expandedNodes[worker] = 0;
+            for(size_t first = nextQuery.fetch_add(chunkSize); first < size; first = nextQuery.fetch_add(chunkSize)) {
+                const size_t last = std::min(first + chunkSize, size);
+                for(size_t i = first; i < last; ++i) {
+                    (*routes)[i] = finder.pathFind((*queries)[i].first, (*queries)[i].second);
+                    expandedNodes[worker] += finder.getExpandedNodes();
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if(--runningWorkers == 0) { batchDone.notify_one(); }
+        }
+    }
+public:
+    // FinderArgs are passed to the constructor of every pathfinder after the map. e.g. true for JumpPointPathFinder (JPS+)
+    template<class... Args>
+    BatchPathFinder(const GridMap& Map, const int Threads, const Args&... FinderArgs) : map(Map), nextQuery(0) {
+        const int threads = std::max(Threads, 1);
+        expandedNodes.assign(threads, 0);
+        for(int i = 0; i < threads; ++i) { finders.emplace_back(new Finder(Map, FinderArgs...)); }
+        for(int i = 0; i < threads; ++i) { workers.emplace_back(&BatchPathFinder::workerLoop, this, i); }
+    }
+
+    ~BatchPathFinder() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeUp.notify_all();
+        for(std::thread& worker : workers) { worker.join(); }
+    }
+
+    BatchPathFinder(const BatchPathFinder&) = delete;
+    BatchPathFinder& operator=(const BatchPathFinder&) = delete;
+
+    const GridMap& getMap() const { return map; }
+    int getThreads() const { return workers.size(); }
+
+    long long getExpandedNodes() const {
+        long long total = 0;
+        for(const long long expanded : expandedNodes) { total += expanded; }
+        return total;
+    }
+
+    // the route of every query, in the order of the queries. A route is a string of direction digits, empty if not found
+    std::vector<std::string> pathFindBatch(const std::vector<std::pair<Position2D, Position2D> >& Queries) {
+        std::vector<std::string> result(Queries.size());
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queries = &Queries;
+            routes = &result;
+            nextQuery = 0;
+            runningWorkers = workers.size();
+            ++batch;
+        }
+        wakeUp.notify_all();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        batchDone.wait(lock, [&]() { return runningWorkers == 0; });
+        queries = nullptr;
+        routes = nullptr;
+        return result;
+    }
+};
+
+#endif // _BATCHPATHFINDER_
@@ -0,0 +1,197 @@
+/**
+Bidirectional A* with balanced potentials, in the BAE* order. https://en.wikipedia.org/wiki/Bidirectional_search
+A forward search from the start and a backward search from the finish run at the same time, and every step expands the frontier
+with fewer open nodes. Each frontier keeps its own node maps, with a directionsMap pointing to its own root, so the route is
+stitched at the meeting cell: the forward half is read back to the start and the backward half to the finish.
+A node is ordered by b(n) = 2 G(n) + H(n, other root) - H(n, own root), twice the balanced potential. With a consistent estimate
+the sum of the smallest b of both frontiers never exceeds twice the cost of a route left to find, so the search stops when it
+reaches twice best, the cheapest route through a cell reached by both frontiers. The nodes whose G(n) + H(n) can not beat best are
+not expanded. On the mazes and the maps of random obstacles it expands about as many nodes as PathFinder with the octile estimate
+or fewer, on open maps with a few long walls it expands more.
+The heuristic and the connectivity are the policies of PathFinder (Heuristics.h). The heuristic must be consistent (octile,
+Manhattan with FourConnected, LandmarkHeuristic), the truncated Euclidean of defaultHeuristic is not. */
+
+#ifndef _BIDIRECTIONALPATHFINDER_
+#define _BIDIRECTIONALPATHFINDER_
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <climits>
+#include "GridMap.h"
+#include "Node.h"
+#include "Route.h"
+#include "OpenList.h"
+#include "GenerationMap.h"
+#include "Heuristics.h"
+
+template<class Heuristic = OctileHeuristic, class Connectivity = defaultConnectivity>
+class BidirectionalPathFinder {
+private:
+    struct Frontier {
+        std::vector<int> levelMap; // G(n) from the root of the frontier. -1: not reached
+        std::vector<unsigned char> closedNodesMap; // map of closed (tried-out) nodes
+        std::vector<unsigned char> directionsMap; // map of directions to the parent, towards the root
+        GenerationMap nodeGenerations; // cells of levelMap and closedNodesMap written by the current search
+        IndexedHeapOpenList openNodes; // list of open (not-yet-tried) nodes
+        long long expandedNodes = 0;
+        long long firstHeapOperations = 0; // operations of the open list before the last pathFind call
+        Heuristic toTarget; // estimate to the root of the other frontier
+        Heuristic toRoot; // estimate back to the root of the frontier
+    };
+
+    const GridMap& map;
+    Frontier frontiers[2]; // 0: forward from the start, 1: backward from the finish
+    int bestLevel = INT_MAX; // cost of the best route found
+    int meetingIndex = -1; // flattened index of the cell joining the best route
+
+    // clear the Node maps of a cell the first time the current search of the frontier touches it
+    static void touchNode(Frontier& frontier, const int index) {
+        if(frontier.nodeGenerations.touch(index)) {
+            frontier.levelMap[index] = -1;
+            frontier.closedNodesMap[index] = 0;
+        }
+    }
+
+    // G(n) of a cell reached by a frontier. -1: not reached by its current search
+    static int getLevel(const Frontier& frontier, const int index) {
+        return frontier.nodeGenerations.isCurrent(index) ? frontier.levelMap[index] : -1;
+    }
+
+    // b(n) of a node reached by a frontier at a level
+    static int getPriority(const Frontier& frontier, const int Level, const int x, const int y) {
+        return 2 * Level + frontier.toTarget.estimate(x, y) - frontier.toRoot.estimate(x, y);
+    }
+
+    // pop and expand the best node of a frontier
+    void expand(const int side) {
+        Frontier& frontier = frontiers[side];
+        const Frontier& other = frontiers[1 - side];
+        const int n0Index = frontier.openNodes.top().index;
+        frontier.openNodes.pop();
+        const int x = n0Index % map.getWidth();
+        const int y = n0Index / map.getWidth();
+        const int n0Level = frontier.levelMap[n0Index];
+        frontier.closedNodesMap[n0Index] = 1;
+        if(n0Level + frontier.toTarget.estimate(x, y) >= bestLevel) { return; } // no route through it beats best
+        ++frontier.expandedNodes;
+
+        // generate moves (child nodes) in the free directions of the connectivity
+        for(unsigned int moves = getFreeDirections(map.getNeighbourhood(x, y)) & Connectivity::mask; moves != 0;
+            moves &= moves - 1) {
+            const int i = lowestBit(moves);
+            const int xdx = x + dx[i];
+            const int ydy = y + dy[i];
+            const int childIndex = map.getIndex(xdx, ydy);
+            touchNode(frontier, childIndex);
+            if(frontier.closedNodesMap[childIndex] == 1) { continue; }
+
+            const int level = n0Level + Connectivity::stepCost(i);
+            int& childLevel = frontier.levelMap[childIndex];
+            if(childLevel != -1 && childLevel <= level) { continue; }
+
+            // the other frontier already reached the cell: a complete route
+            const int otherLevel = getLevel(other, childIndex);
+            if(otherLevel != -1 && level + otherLevel < bestLevel) {
+                bestLevel = level + otherLevel;
+                meetingIndex = childIndex;
+            }
+            // a child which can not beat best is dropped, but the meeting cell is kept for the stitching
+            if(level + frontier.toTarget.estimate(xdx, ydy) >= bestLevel && childIndex != meetingIndex) { continue; }
+
+            const NodeKey child{getPriority(frontier, level, xdx, ydy), childIndex};
+            if(childLevel == -1) { frontier.openNodes.push(child); }
+            else { frontier.openNodes.decreaseKey(child); }
+            childLevel = level;
+            frontier.directionsMap[childIndex] = reverseDirection(i);
+        }
+    }
+public:
+    // the heuristics with data of their own (e.g. LandmarkHeuristic) are given to the constructor
+    explicit BidirectionalPathFinder(const GridMap& Map, const Heuristic& Estimate = Heuristic()) : map(Map) {
+        for(Frontier& frontier : frontiers) {
+            frontier.toTarget = Estimate;
+            frontier.toRoot = Estimate;
+            frontier.levelMap.resize(Map.getSize());
+            frontier.closedNodesMap.resize(Map.getSize());
+            frontier.directionsMap.resize(Map.getSize());
+            frontier.openNodes.resize(Map.getWidth(), Map.getHeight());
+            frontier.nodeGenerations.resize(Map.getSize());
+        }
+    }
+
+    const GridMap& getMap() const { return map; }
+    long long getForwardExpandedNodes() const { return frontiers[0].expandedNodes; }
+    long long getBackwardExpandedNodes() const { return frontiers[1].expandedNodes; }
+    long long getExpandedNodes() const { return frontiers[0].expandedNodes + frontiers[1].expandedNodes; }
+
+    long long getHeapOperations() const {
+        long long operations = 0;
+        for(const Frontier& frontier : frontiers) { operations += frontier.openNodes.getOperations() - frontier.firstHeapOperations; }
+        return operations;
+    }
+
+    // Bidirectional A* (BAE*). The route returned is in the compact form, like PathFinder::findRoute
+    Route findRoute(const Position2D& Start, const Position2D& Finish) {
+        const Position2D roots[2] = {Start, Finish};
+        for(int side = 0; side < 2; ++side) {
+            Frontier& frontier = frontiers[side];
+            frontier.expandedNodes = 0;
+            frontier.firstHeapOperations = frontier.openNodes.getOperations();
+            frontier.nodeGenerations.nextGeneration(); // the Node maps are reset lazily
+            frontier.toTarget.setFinish(roots[1 - side]);
+            frontier.toRoot.setFinish(roots[side]);
+        }
+        if(map.isObstacle(Start.xPos, Start.yPos) || map.isObstacle(Finish.xPos, Finish.yPos)) { return Route(); }
+
+        for(int side = 0; side < 2; ++side) {
+            const int rootIndex = map.getIndex(roots[side]);
+            touchNode(frontiers[side], rootIndex);
+            frontiers[side].levelMap[rootIndex] = 0;
+            const int rootPriority = getPriority(frontiers[side], 0, roots[side].xPos, roots[side].yPos);
+            frontiers[side].openNodes.push(NodeKey{rootPriority, rootIndex});
+        }
+        bestLevel = Start == Finish ? 0 : INT_MAX;
+        meetingIndex = Start == Finish ? map.getIndex(Start) : -1;
+
+        while(!frontiers[0].openNodes.empty() && !frontiers[1].openNodes.empty()) {
+            // no route left to find is cheaper than best
+            if(bestLevel != INT_MAX && static_cast<long long>(frontiers[0].openNodes.top().priority)
+                + frontiers[1].openNodes.top().priority >= 2LL * bestLevel) {
+                break;
+            }
+            expand(frontiers[0].openNodes.size() <= frontiers[1].openNodes.size() ? 0 : 1);
+        }
+        for(Frontier& frontier : frontiers) { frontier.openNodes.clear(); } // empty the leftover nodes
+        if(meetingIndex == -1) { return Route(); } // no route found
+
+        // forward half: from the meeting cell back to the start
+        const int mapWidth = map.getWidth();
+        Route path;
+        int x = meetingIndex % mapWidth;
+        int y = meetingIndex / mapWidth;
+        while(!(x == Start.xPos && y == Start.yPos)) {
+            const int j = frontiers[0].directionsMap[map.getIndex(x, y)];
+            path.append(reverseDirection(j));
+            x += dx[j];
+            y += dy[j];
+        }
+        path.reverse();
+
+        // backward half: its parents already point towards the finish
+        x = meetingIndex % mapWidth;
+        y = meetingIndex / mapWidth;
+        while(!(x == Finish.xPos && y == Finish.yPos)) {
+            const int j = frontiers[1].directionsMap[map.getIndex(x, y)];
+            path.append(j);
+            x += dx[j];
+            y += dy[j];
+        }
+        return path;
+    }
+
+    // the route as a string of direction digits
+    std::string pathFind(const Position2D& Start, const Position2D& Finish) { return findRoute(Start, Finish).toString(); }
+};
+
+#endif // _BIDIRECTIONALPATHFINDER_
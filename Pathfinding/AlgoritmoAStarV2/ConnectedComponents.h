@@ -0,0 +1,204 @@
+/**
+Connected components of the free cells, to reject in O(1) the routes between cells which are not connected, without searching the
+whole region of the start. https://en.wikipedia.org/wiki/Connected-component_labeling
+Every free cell has a label, and the labels are the sets of a union-find (disjoint set) structure: two cells are connected when
+their labels have the same root. The labels are built once by flood fill and updated cell by cell with the changes of the map:
+- a cell becoming free joins its own new set with the sets of its free neighbours (union).
+- a cell becoming an obstacle can split its component. If its free neighbours are still connected to each other around it, nothing
+changes. Otherwise a flood fill from one neighbour stops as soon as it reaches the others (no split), or it labels the part it
+filled with a new set when it can not reach them.
+The map is edited by anyone, and the labels catch up with it on the next query (update): the changes since the version of the
+labels are read from the log of the map (GridMap::getChangesSince) and applied in order, each one against the cells as the labels
+see them at that point, so a split hidden by a later change is not missed. When the log does not go back far enough, the labels
+are built again. */
+
+#ifndef _CONNECTEDCOMPONENTS_
+#define _CONNECTEDCOMPONENTS_
+
+#include <vector>
+#include <algorithm>
+#include "GridMap.h"
+#include "Node.h"
+#include "GenerationMap.h"
+#include "Heuristics.h"
+
+template<class Connectivity = defaultConnectivity>
+class ConnectedComponents {
+private:
+    const GridMap& map;
+    std::vector<int> labels; // set of every free cell. -1: obstacle. -2: free, not labelled yet (build)
+    std::vector<int> parents; // union-find parent of every set
+    std::vector<int> setSizes; // cells of every root set, for the union by size
+    unsigned int mapVersion; // version of the map of the labels
+    GenerationMap visited; // cells reached by the current flood fill
+    std::vector<int> fillQueue;
+    std::vector<CellChange> changes; // the changes of the map read by the last update
+
+    int newSet(const int Size) {
+        parents.push_back(parents.size());
+        setSizes.push_back(Size);
+        return parents.size() - 1;
+    }
+
+    int findRoot(int set) const {
+        while(parents[set] != set) { set = parents[set]; }
+        return set;
+    }
+
+    // find with path compression
+    int compressRoot(const int set) {
+        const int root = findRoot(set);
+        for(int s = set; parents[s] != root && s != root; ) {
+            const int next = parents[s];
+            parents[s] = root;
+            s = next;
+        }
+        return root;
+    }
+
+    void unite(const int a, const int b) {
+        int rootA = compressRoot(a);
+        int rootB = compressRoot(b);
+        if(rootA == rootB) { return; }
+        if(setSizes[rootA] < setSizes[rootB]) { std::swap(rootA, rootB); }
+        parents[rootB] = rootA;
+        setSizes[rootA] += setSizes[rootB];
+    }
+
+    /* flood fill from a cell over the free cells of the labels until every cell of Targets is reached (true), or the region ends
+    (false). the cells filled are left in fillQueue */
+    bool fillRegion(const int From, const std::vector<int>& Targets) {
+        const int mapWidth = map.getWidth();
+        visited.nextGeneration();
+        fillQueue.clear();
+        fillQueue.push_back(From);
+        visited.touch(From);
+        int found = 0;
+        for(const int target : Targets) { found += target == From ? 1 : 0; }
+        for(size_t head = 0; head < fillQueue.size(); ++head) {
+            if(found == static_cast<int>(Targets.size())) { return true; }
+            const int x = fillQueue[head] % mapWidth;
+            const int y = fillQueue[head] / mapWidth;
+            for(int i = 0; i < directions; i += Connectivity::step) {
+                if(!isFree(x + dx[i], y + dy[i])) { continue; }
+                const int index = map.getIndex(x + dx[i], y + dy[i]);
+                if(!visited.touch(index)) { continue; }
+                fillQueue.push_back(index);
+                found += std::count(Targets.begin(), Targets.end(), index);
+            }
+        }
+        return found == static_cast<int>(Targets.size());
+    }
+
+    // a cell is free for the labels. they can be behind the map while the changes are applied
+    bool isFree(const int x, const int y) const { return map.isInside(x, y) && labels[map.getIndex(x, y)] != -1; }
+
+    // the free neighbours of a cell
+    std::vector<int> getFreeNeighbours(const int x, const int y) const {
+        std::vector<int> neighbours;
+        for(int i = 0; i < directions; i += Connectivity::step) {
+            if(isFree(x + dx[i], y + dy[i])) { neighbours.push_back(map.getIndex(x + dx[i], y + dy[i])); }
+        }
+        return neighbours;
+    }
+
+    // the neighbours of a cell are connected to each other by moves between them, without the cell
+    bool areNeighboursConnected(const std::vector<int>& Neighbours) const {
+        const int mapWidth = map.getWidth();
+        const int count = Neighbours.size();
+        std::vector<int> groups(count);
+        for(int a = 0; a < count; ++a) { groups[a] = a; }
+        for(int a = 0; a < count; ++a) {
+            for(int b = a + 1; b < count; ++b) {
+                const int xd = Neighbours[b] % mapWidth - Neighbours[a] % mapWidth;
+                const int yd = Neighbours[b] / mapWidth - Neighbours[a] / mapWidth;
+                for(int i = 0; i < directions; i += Connectivity::step) {
+                    if(dx[i] != xd || dy[i] != yd) { continue; }
+                    const int from = groups[b], to = groups[a];
+                    for(int& group : groups) { group = group == from ? to : group; }
+                }
+            }
+        }
+        return std::count(groups.begin(), groups.end(), groups[0]) == count;
+    }
+
+    // a free cell became an obstacle
+    void removeCell(const int index) {
+        labels[index] = -1;
+        std::vector<int> neighbours = getFreeNeighbours(index % map.getWidth(), index / map.getWidth());
+        if(neighbours.size() < 2 || areNeighboursConnected(neighbours)) { return; }
+
+        // fill from the first neighbour. the part not reaching the others is a new component, until one part is left
+        while(neighbours.size() > 1) {
+            const int from = neighbours.front();
+            neighbours.erase(neighbours.begin());
+            if(fillRegion(from, neighbours)) { return; }
+            const int set = newSet(fillQueue.size());
+            for(const int index : fillQueue) { labels[index] = set; }
+            neighbours.erase(std::remove_if(neighbours.begin(), neighbours.end(),
+                [&](const int index) { return visited.isCurrent(index); }), neighbours.end());
+        }
+    }
+
+    // an obstacle became a free cell
+    void addCell(const int index) {
+        labels[index] = newSet(1);
+        for(const int neighbour : getFreeNeighbours(index % map.getWidth(), index / map.getWidth())) {
+            unite(labels[neighbour], labels[index]);
+        }
+    }
+public:
+    explicit ConnectedComponents(const GridMap& Map) : map(Map), mapVersion(Map.getVersion()) {
+        visited.resize(Map.getSize());
+        build();
+    }
+
+    const GridMap& getMap() const { return map; }
+
+    // label all the cells again by flood fill
+    void build() {
+        labels.resize(map.getSize());
+        for(int index = 0; index < map.getSize(); ++index) {
+            labels[index] = map.isObstacle(index % map.getWidth(), index / map.getWidth()) ? -1 : -2;
+        }
+        parents.clear();
+        setSizes.clear();
+        for(int index = 0; index < map.getSize(); ++index) {
+            if(labels[index] != -2) { continue; }
+            fillRegion(index, std::vector<int>(1, -1));
+            const int set = newSet(fillQueue.size());
+            for(const int cell : fillQueue) { labels[cell] = set; }
+        }
+        mapVersion = map.getVersion();
+    }
+
+    // apply the changes of the map since the last update to the labels, or build them again when the log does not have them all
+    void update() {
+        if(map.getVersion() == mapVersion) { return; }
+        if(!map.getChangesSince(mapVersion, changes)) {
+            build();
+            return;
+        }
+        for(const CellChange& change : changes) {
+            if(change.obstacle && labels[change.index] != -1) { removeCell(change.index); }
+            else if(!change.obstacle && labels[change.index] == -1) { addCell(change.index); }
+        }
+        mapVersion = map.getVersion();
+        if(parents.size() > static_cast<size_t>(map.getSize()) * 2) { build(); } // too many sets after many changes
+    }
+
+    // the component of a free cell, -1 for an obstacle. two cells are connected when they have the same component
+    int getComponent(const int x, const int y) {
+        update();
+        const int label = labels[map.getIndex(x, y)];
+        return label == -1 ? -1 : findRoot(label);
+    }
+
+    // a route can exist between two cells
+    bool isConnected(const Position2D& Start, const Position2D& Finish) {
+        const int component = getComponent(Start.xPos, Start.yPos);
+        return component != -1 && component == getComponent(Finish.xPos, Finish.yPos);
+    }
+};
+
+#endif // _CONNECTEDCOMPONENTS_
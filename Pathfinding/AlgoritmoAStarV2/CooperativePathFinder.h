@@ -0,0 +1,261 @@
+/**
+Windowed Hierarchical Cooperative A* (WHCA*). https://www.aaai.org/Papers/AIIDE/2005/AIIDE05-020.pdf
+The agents are planned one after the other in space-time (x, y, t), and every planned step is written in a reservation table shared
+by all of them, so the later agents walk around the cells (and the swaps of cells) reserved by the earlier ones. Every search only
+looks a window of steps ahead: the agents are planned window after window until all of them arrive.
+The heuristic is the true distance to the finish ignoring the other agents, read from the flow field of the finish
+(FlowFieldPathFinder.h), the abstract search of the paper. A field is as big as the map, so at most CachedFields finishes of a
+batch get one, and the agents of the other finishes use the octile distance: their searches expand more nodes, but no field is
+dropped and searched again in every window. A move costs 10 or 14 and waiting a step costs 10, and every step,
+waiting or not, takes one time step. An agent at its finish stays there, other agents can still cross it if they were planned
+first, the agent steps aside and comes back.
+The reservation table and the states of the search are hash tables keyed by (time, cell) (GenerationHashMap.h), they only keep the
+reserved cells and the reached states, so their memory follows the agents and the window and not the size of the map. The table is
+emptied when a new window starts, the searches only read the time steps of their window.
+The routes are the cells of every agent at every time step, an agent stays at its last cell after its route ends. */
+
+#ifndef _COOPERATIVEPATHFINDER_
+#define _COOPERATIVEPATHFINDER_
+
+#include <vector>
+#include <queue>
+#include <utility>
+#include <algorithm>
+#include "GridMap.h"
+#include "Node.h"
+#include "GenerationHashMap.h"
+#include "Heuristics.h"
+#include "FlowFieldPathFinder.h"
+
+// the agent holding every cell at every time step of the window
+class ReservationTable {
+private:
+    long long size = 0; // cells of the map
+    GenerationHashMap<long long> agents; // t * size + cell: the agent. -1: released
+
+public:
+    // an empty table for a map of Size cells
+    void reset(const int Size) {
+        size = Size;
+        agents.release();
+    }
+
+    // forget all the reservations, before a new window
+    void clear() { agents.clear(); }
+
+    // the agent holding a cell at a time step. -1: free
+    int getAgent(const int index, const int t) const {
+        const int* agent = agents.find(t * size + index);
+        return agent == nullptr ? -1 : *agent;
+    }
+
+    void reserve(const int index, const int t, const int Agent) { *agents.insert(t * size + index, Agent) = Agent; }
+
+    // free a cell reserved by an agent
+    void release(const int index, const int t, const int Agent) {
+        int* agent = agents.find(t * size + index);
+        if(agent != nullptr && *agent == Agent) { *agent = -1; }
+    }
+
+    // an agent can be at a cell at time t coming from a cell at time t - 1: no other agent holds it, or swaps cells with it
+    bool canMove(const int from, const int to, const int t, const int Agent) const {
+        const int holder = getAgent(to, t);
+        if(holder != -1 && holder != Agent) { return false; }
+        if(from == to) { return true; }
+        const int other = getAgent(from, t);
+        return other == -1 || other == Agent || getAgent(to, t - 1) != other;
+    }
+};
+
+template<class Connectivity = defaultConnectivity>
+class CooperativePathFinder {
+private:
+    const GridMap& map;
+    const int window; // time steps searched ahead for every agent
+    ReservationTable reservations;
+    const int cachedFields; // the most finishes of a batch with a flow field
+    FlowFieldPathFinder<Connectivity> fields; // the distances to the finishes
+
+    // a (cell, step) state reached by the search of a window
+    struct SpaceTimeNode {
+        int index; // the cell
+        int step; // time steps from the start of the window
+        int level; // G(n)
+        int parent; // the node of the previous step. -1: the start
+    };
+    std::vector<SpaceTimeNode> nodes; // the states reached by the current search
+    GenerationHashMap<long long> stateNodes; // step * cells + cell: its node in nodes
+    std::vector<int> windowCells; // cells of the last searched window, from step 1
+    long long expandedNodes = 0; // nodes expanded by the last planning
+    long long heapOperations = 0;
+
+    // the finish can be kept from a step to the end of the window
+    bool canStay(const int index, const int now, const int step, const int Agent) const {
+        for(int s = step + 1; s <= window; ++s) {
+            if(!reservations.canMove(index, index, now + s, Agent)) { return false; }
+        }
+        return true;
+    }
+
+    /* space-time A* of the next window of an agent, estimated with the flow field of its finish (UseField) or the octile distance.
+    the cells of every step are left in windowCells */
+    void searchWindow(const int Agent, const int StartIndex, const int FinishIndex, const int now, const bool UseField) {
+        const int mapWidth = map.getWidth();
+        const long long size = map.getSize();
+        const int xFinish = FinishIndex % mapWidth, yFinish = FinishIndex / mapWidth;
+        const std::vector<int>* distances = UseField ? &fields.getField(Position2D(xFinish, yFinish)).levelMap : nullptr;
+        // the distance to the finish. -1: no route
+        auto estimate = [&](const int index) {
+            if(distances != nullptr) { return (*distances)[index]; }
+            return octileDistance(xFinish - index % mapWidth, yFinish - index / mapWidth);
+        };
+        std::priority_queue<NodeKey> openNodes; // the index of a key is its node. the old entries are skipped
+        nodes.clear();
+        stateNodes.clear();
+
+        int best = -1; // the reached node with the latest step, in case no state reaches the end of the window
+        if(estimate(StartIndex) != -1) { // else there is no route to the finish, and the agent waits
+            nodes.push_back(SpaceTimeNode{StartIndex, 0, 0, -1});
+            stateNodes.insert(StartIndex, 0);
+            openNodes.push(NodeKey{estimate(StartIndex), 0});
+            ++heapOperations;
+            best = 0;
+        }
+        while(!openNodes.empty()) {
+            const NodeKey n0Key = openNodes.top();
+            openNodes.pop();
+            ++heapOperations;
+            const SpaceTimeNode n0 = nodes[n0Key.index]; // a copy, the children are added to nodes
+            if(n0Key.priority > n0.level + estimate(n0.index)) { continue; } // an old entry of a node reached again
+            ++expandedNodes;
+            if(n0.step > nodes[best].step) { best = n0Key.index; }
+            if(n0.step == window || (n0.index == FinishIndex && canStay(n0.index, now, n0.step, Agent))) {
+                best = n0Key.index;
+                break;
+            }
+
+            const int x = n0.index % mapWidth;
+            const int y = n0.index / mapWidth;
+            for(int i = 0; i <= directions; ++i) { // the moves of the connectivity, and waiting (i == directions)
+                const bool wait = i == directions;
+                if(!wait && i % Connectivity::step != 0) { continue; }
+                const int xdx = wait ? x : x + dx[i];
+                const int ydy = wait ? y : y + dy[i];
+                if(!map.isInside(xdx, ydy) || map.isObstacle(xdx, ydy)) { continue; }
+                const int childIndex = map.getIndex(xdx, ydy);
+                const int childEstimate = estimate(childIndex);
+                if(childEstimate == -1 || !reservations.canMove(n0.index, childIndex, now + n0.step + 1, Agent)) {
+                    continue;
+                }
+
+                const int m0Level = n0.level + (wait ? 10 : Connectivity::stepCost(i));
+                bool inserted = false;
+                const int childNode = *stateNodes.insert((n0.step + 1) * size + childIndex, nodes.size(), &inserted);
+                if(inserted) { nodes.push_back(SpaceTimeNode{childIndex, n0.step + 1, m0Level, n0Key.index}); }
+                else if(nodes[childNode].level <= m0Level) { continue; }
+                else {
+                    nodes[childNode].level = m0Level;
+                    nodes[childNode].parent = n0Key.index;
+                }
+                openNodes.push(NodeKey{m0Level + childEstimate, childNode});
+                ++heapOperations;
+            }
+        }
+
+        // the cells from the last state back to the start. the agent waits at the last one until the end of the window
+        windowCells.assign(window, best == -1 ? StartIndex : nodes[best].index);
+        for(int node = best; node != -1 && nodes[node].step > 0; node = nodes[node].parent) {
+            windowCells[nodes[node].step - 1] = nodes[node].index;
+        }
+    }
+public:
+    /* CachedFields: the most flow fields kept, one per finish, every one a map of distances as big as the map. the other finishes
+    of a batch are estimated with the octile distance */
+    explicit CooperativePathFinder(const GridMap& Map, const int Window = 16, const int CachedFields = 4)
+        : map(Map), window(std::max(Window, 1)), cachedFields(std::max(CachedFields, 1)), fields(Map, cachedFields) {}
+
+    const GridMap& getMap() const { return map; }
+    int getWindow() const { return window; }
+    long long getExpandedNodes() const { return expandedNodes; }
+    long long getHeapOperations() const { return heapOperations; }
+
+    /* plan the routes of a batch of agents (start, finish) in one pass, at most MaxSteps time steps. the earlier agents of the
+    batch have priority. the route of every agent is its cell at every time step, from its start */
+    std::vector<std::vector<Position2D> > planRoutes(const std::vector<std::pair<Position2D, Position2D> >& Agents,
+        const int MaxSteps) {
+        expandedNodes = 0;
+        heapOperations = 0;
+        reservations.reset(map.getSize());
+        const int agentsCount = Agents.size();
+        std::vector<std::vector<int> > cells(agentsCount);
+        for(int a = 0; a < agentsCount; ++a) { cells[a].push_back(map.getIndex(Agents[a].first)); }
+
+        // the first CachedFields finishes of the batch get a flow field, so the fields are never dropped during the batch
+        std::vector<int> fieldFinishes;
+        std::vector<bool> useField(agentsCount);
+        for(int a = 0; a < agentsCount; ++a) {
+            const int finishIndex = map.getIndex(Agents[a].second);
+            useField[a] = std::find(fieldFinishes.begin(), fieldFinishes.end(), finishIndex) != fieldFinishes.end();
+            if(!useField[a] && static_cast<int>(fieldFinishes.size()) < cachedFields) {
+                fieldFinishes.push_back(finishIndex);
+                useField[a] = true;
+            }
+        }
+
+        for(int now = 0; now < MaxSteps; now += window) {
+            bool arrived = true;
+            for(int a = 0; a < agentsCount; ++a) { arrived = arrived && cells[a].back() == map.getIndex(Agents[a].second); }
+            if(arrived && now > 0) { break; }
+
+            // the searches of the window only read its time steps, the reservations of the last one are dropped
+            reservations.clear();
+            // the agents not planned yet hold their cells for the next step, so they can always wait there
+            for(int a = 0; a < agentsCount; ++a) {
+                reservations.reserve(cells[a].back(), now, a);
+                reservations.reserve(cells[a].back(), now + 1, a);
+            }
+            for(int a = 0; a < agentsCount; ++a) {
+                reservations.release(cells[a].back(), now + 1, a);
+                searchWindow(a, cells[a].back(), map.getIndex(Agents[a].second), now, useField[a]);
+                for(int s = 0; s < window; ++s) {
+                    reservations.reserve(windowCells[s], now + s + 1, a);
+                    cells[a].push_back(windowCells[s]);
+                }
+            }
+        }
+
+        // the agents stay at their last cell, the waiting steps at the end of the routes are dropped
+        std::vector<std::vector<Position2D> > routes(agentsCount);
+        const int mapWidth = map.getWidth();
+        for(int a = 0; a < agentsCount; ++a) {
+            while(cells[a].size() > 1 && cells[a].back() == cells[a][cells[a].size() - 2]) { cells[a].pop_back(); }
+            for(const int index : cells[a]) { routes[a].push_back(Position2D(index % mapWidth, index / mapWidth)); }
+        }
+        return routes;
+    }
+
+    // collisions between routes: two agents in the same cell at the same time step, or swapping their cells
+    static int countConflicts(const std::vector<std::vector<Position2D> >& Routes) {
+        size_t steps = 0;
+        for(const std::vector<Position2D>& route : Routes) { steps = std::max(steps, route.size()); }
+        int conflicts = 0;
+        for(size_t t = 0; t < steps; ++t) {
+            for(size_t a = 0; a < Routes.size(); ++a) {
+                for(size_t b = a + 1; b < Routes.size(); ++b) {
+                    const std::vector<Position2D>& ra = Routes[a];
+                    const std::vector<Position2D>& rb = Routes[b];
+                    if(ra.empty() || rb.empty()) { continue; }
+                    const Position2D& pa = ra[std::min(t, ra.size() - 1)];
+                    const Position2D& pb = rb[std::min(t, rb.size() - 1)];
+                    if(pa == pb) { ++conflicts; }
+                    else if(t > 0 && pa == rb[std::min(t - 1, rb.size() - 1)] && pb == ra[std::min(t - 1, ra.size() - 1)]) {
+                        ++conflicts;
+                    }
+                }
+            }
+        }
+        return conflicts;
+    }
+};
+
+#endif // _COOPERATIVEPATHFINDER_
@@ -0,0 +1,243 @@
+/**
+D* Lite: incremental replanning when a few cells of the map change. http://idm-lab.org/bib/abstracts/papers/aaai02b.pdf
+The search runs backwards from the finish and keeps, for every cell, its distance to the finish (levelMap, named g) and a one step
+lookahead of it (rhsMap). The obstacles are edited on the map, by anyone: the next pathFind to the same finish reads the changes
+since the version it saw from the log of the map (GridMap::getChangesSince), queues only the changed cells and their neighbours
+again, and re-expands only the nodes whose distance really changed. The Start can move between calls (km keeps the queued keys
+valid). A new finish, or more changes than the log keeps, starts a full search. */
+
+#ifndef _DSTARLITEPATHFINDER_
+#define _DSTARLITEPATHFINDER_
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <climits>
+#include "GridMap.h"
+#include "Node.h"
+#include "Route.h"
+
+class DStarLitePathFinder {
+private:
+    static constexpr int infinity = INT_MAX / 2;
+
+    struct Key {
+        int first, second; // [min(g, rhs) + H(n) + km, min(g, rhs)]
+        bool operator<(const Key& Other) const { return first < Other.first || (first == Other.first && second < Other.second); }
+    };
+
+    struct HeapEntry {
+        Key key;
+        int index; // flattened index of the cell
+    };
+
+    const GridMap& map;
+    std::vector<int> levelMap; // G(n): distance to the finish. infinity: not known
+    std::vector<int> rhsMap; // one step lookahead of G(n): the best neighbour level plus the step cost
+    std::vector<int> heapIndexMap; // map of heap slots. -1: not queued
+    std::vector<HeapEntry> heap; // binary heap of the inconsistent nodes (G(n) != rhs)
+    Position2D lastStart, goal;
+    int km = 0; // sum of the estimates between the starts of the calls. keeps the old keys as lower bounds
+    bool planned = false;
+    unsigned int mapVersion = 0; // the version of the map the distances were computed for
+    std::vector<CellChange> changes; // the changes of the map read by the last pathFind call
+    long long expandedNodes = 0; // nodes expanded by the last pathFind call
+    long long heapOperations = 0; // inserts, updates and removals of the heap in the last pathFind call
+
+    static int stepCost(const int Direction) { return directions == 8 && Direction % 2 == 1 ? 14 : 10; }
+
+    int estimate(const int index) const {
+        return octileDistance(index % map.getWidth() - lastStart.xPos, index / map.getWidth() - lastStart.yPos);
+    }
+
+    Key calculateKey(const int index) const {
+        const int level = std::min(levelMap[index], rhsMap[index]);
+        return Key{level >= infinity ? infinity : level + estimate(index) + km, level};
+    }
+
+    void place(const HeapEntry& Value, const int slot) {
+        heap[slot] = Value;
+        heapIndexMap[Value.index] = slot;
+    }
+
+    void siftUp(int slot) {
+        const HeapEntry value = heap[slot];
+        while(slot > 0) {
+            const int parent = (slot - 1) / 2;
+            if(!(value.key < heap[parent].key)) { break; }
+            place(heap[parent], slot);
+            slot = parent;
+        }
+        place(value, slot);
+    }
+
+    void siftDown(int slot) {
+        const HeapEntry value = heap[slot];
+        const int size = heap.size();
+        while(true) {
+            int best = slot * 2 + 1;
+            if(best >= size) { break; }
+            if(best + 1 < size && heap[best + 1].key < heap[best].key) { ++best; }
+            if(!(heap[best].key < value.key)) { break; }
+            place(heap[best], slot);
+            slot = best;
+        }
+        place(value, slot);
+    }
+
+    void removeFromHeap(const int index) {
+        ++heapOperations;
+        const int slot = heapIndexMap[index];
+        heapIndexMap[index] = -1;
+        const HeapEntry last = heap.back();
+        heap.pop_back();
+        if(slot == static_cast<int>(heap.size())) { return; }
+        place(last, slot);
+        siftUp(slot);
+        siftDown(heapIndexMap[last.index]);
+    }
+
+    // recalculate rhs of a cell and queue it if it is inconsistent
+    void updateVertex(const int index) {
+        const int x = index % map.getWidth();
+        const int y = index / map.getWidth();
+        if(map.isObstacle(x, y)) { rhsMap[index] = infinity; }
+        else if(x == goal.xPos && y == goal.yPos) { rhsMap[index] = 0; }
+        else {
+            int best = infinity;
+            for(int i = 0; i < directions; ++i) {
+                const int xdx = x + dx[i];
+                const int ydy = y + dy[i];
+                if(!map.isInside(xdx, ydy) || map.isObstacle(xdx, ydy)) { continue; }
+                const int level = levelMap[map.getIndex(xdx, ydy)];
+                if(level < infinity) { best = std::min(best, level + stepCost(i)); }
+            }
+            rhsMap[index] = best;
+        }
+
+        const int slot = heapIndexMap[index];
+        if(levelMap[index] == rhsMap[index]) {
+            if(slot != -1) { removeFromHeap(index); }
+        }
+        else if(slot == -1) {
+            ++heapOperations;
+            heap.push_back(HeapEntry{calculateKey(index), index});
+            siftUp(heap.size() - 1);
+        }
+        else {
+            ++heapOperations;
+            heap[slot].key = calculateKey(index);
+            siftUp(slot);
+            siftDown(heapIndexMap[index]);
+        }
+    }
+
+    void updateNeighbours(const int index) {
+        const int x = index % map.getWidth();
+        const int y = index / map.getWidth();
+        for(int i = 0; i < directions; ++i) {
+            const int xdx = x + dx[i];
+            const int ydy = y + dy[i];
+            if(map.isInside(xdx, ydy)) { updateVertex(map.getIndex(xdx, ydy)); }
+        }
+    }
+
+    // a full backwards search from the finish. the node maps are reset
+    void initialize(const Position2D& Start, const Position2D& Finish) {
+        std::fill(levelMap.begin(), levelMap.end(), infinity);
+        std::fill(rhsMap.begin(), rhsMap.end(), infinity);
+        std::fill(heapIndexMap.begin(), heapIndexMap.end(), -1);
+        heap.clear();
+        km = 0;
+        lastStart = Start;
+        goal = Finish;
+        planned = true;
+        mapVersion = map.getVersion();
+        updateVertex(map.getIndex(Finish));
+    }
+
+    void computeShortestPath() {
+        const int startIndex = map.getIndex(lastStart);
+        while(!heap.empty() && (heap.front().key < calculateKey(startIndex) || rhsMap[startIndex] != levelMap[startIndex])) {
+            const int index = heap.front().index;
+            const Key newKey = calculateKey(index);
+            if(heap.front().key < newKey) { // the key was calculated for an older start
+                heap.front().key = newKey;
+                siftDown(0);
+                ++heapOperations;
+                continue;
+            }
+            removeFromHeap(index);
+            ++expandedNodes;
+            if(levelMap[index] > rhsMap[index]) { levelMap[index] = rhsMap[index]; } // overconsistent: the node gets cheaper
+            else {
+                levelMap[index] = infinity; // underconsistent: the node gets more expensive, recalculate it too
+                updateVertex(index);
+            }
+            updateNeighbours(index);
+        }
+    }
+public:
+    explicit DStarLitePathFinder(const GridMap& Map)
+        : map(Map), levelMap(Map.getSize()), rhsMap(Map.getSize()), heapIndexMap(Map.getSize()), lastStart(0, 0), goal(0, 0) {}
+
+    const GridMap& getMap() const { return map; }
+    long long getExpandedNodes() const { return expandedNodes; }
+    long long getHeapOperations() const { return heapOperations; }
+
+    // D* Lite. The route returned is in the compact form, like PathFinder::findRoute
+    Route findRoute(const Position2D& Start, const Position2D& Finish) {
+        expandedNodes = 0;
+        heapOperations = 0;
+        if(!planned || !(Finish == goal)) { initialize(Start, Finish); }
+        else {
+            if(!(Start == lastStart)) {
+                km += octileDistance(Start.xPos - lastStart.xPos, Start.yPos - lastStart.yPos);
+                lastStart = Start;
+            }
+            // the cells changed since the last call and their neighbours are queued again
+            if(map.getVersion() != mapVersion) {
+                if(!map.getChangesSince(mapVersion, changes)) { initialize(Start, Finish); }
+                else {
+                    for(const CellChange& change : changes) {
+                        updateVertex(change.index);
+                        updateNeighbours(change.index);
+                    }
+                    mapVersion = map.getVersion();
+                }
+            }
+        }
+        if(map.isObstacle(Start.xPos, Start.yPos) || map.isObstacle(Finish.xPos, Finish.yPos)) { return Route(); }
+
+        computeShortestPath();
+        if(levelMap[map.getIndex(Start)] >= infinity) { return Route(); } // no route found
+
+        // generate the path from start to finish going down the levels
+        Route path;
+        int x = Start.xPos;
+        int y = Start.yPos;
+        while(!(x == Finish.xPos && y == Finish.yPos) && path.size() < map.getSize()) {
+            int bestDirection = -1, best = infinity;
+            for(int i = 0; i < directions; ++i) {
+                const int xdx = x + dx[i];
+                const int ydy = y + dy[i];
+                if(!map.isInside(xdx, ydy) || map.isObstacle(xdx, ydy)) { continue; }
+                const int level = levelMap[map.getIndex(xdx, ydy)];
+                if(level < infinity && level + stepCost(i) < best) {
+                    best = level + stepCost(i);
+                    bestDirection = i;
+                }
+            }
+            if(bestDirection == -1) { return Route(); }
+            path.append(bestDirection);
+            x += dx[bestDirection];
+            y += dy[bestDirection];
+        }
+        return path;
+    }
+
+    // the route as a string of direction digits
+    std::string pathFind(const Position2D& Start, const Position2D& Finish) { return findRoute(Start, Finish).toString(); }
+};
+
+#endif // _DSTARLITEPATHFINDER_
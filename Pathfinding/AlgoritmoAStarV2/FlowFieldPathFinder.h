@@ -0,0 +1,138 @@
+/**
+Flow fields (Dijkstra maps) for many units going to the same finish. https://www.redblobgames.com/pathfinding/tower-defense/
+A flow field is searched once per finish: a reverse Dijkstra from the finish over the whole map gives the cost to the finish of
+every cell (the integration field) and the direction of its next step (the direction field). The directions use the encoding of
+the directionsMap of PathFinder, the direction to the parent, and here the parent of a cell is its next step to the finish. So
+after the field is built every unit reads its next step in O(1), and a whole route is only a walk over the field.
+The fields are cached per finish (the least recently used one is dropped when the cache is full), and all of them are dropped when
+the version of the map changes. A cached field is returned by reference, it is valid until the next call to the pathfinder. */
+
+#ifndef _FLOWFIELDPATHFINDER_
+#define _FLOWFIELDPATHFINDER_
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include "GridMap.h"
+#include "Node.h"
+#include "Route.h"
+#include "OpenList.h"
+#include "Heuristics.h"
+
+struct FlowField {
+    static constexpr unsigned char noDirection = 255; // the finish, an obstacle or a cell without a route
+
+    std::vector<int> levelMap; // integration field: cost of the route to the finish. -1: no route
+    std::vector<unsigned char> directionsMap; // direction field: direction of the next step to the finish
+    unsigned long long lastUse = 0; // for the cache
+};
+
+template<class Connectivity = defaultConnectivity>
+class FlowFieldPathFinder {
+private:
+    const GridMap& map;
+    const size_t capacity; // fields kept in the cache
+    std::unordered_map<int, FlowField> fields; // by the index of the finish
+    unsigned int mapVersion; // version of the map of the cached fields
+    unsigned long long uses = 0;
+    IndexedHeapOpenList openNodes; // shared by the searches of the fields
+    std::vector<unsigned char> closedNodesMap;
+    long long expandedNodes = 0; // nodes expanded by the last call, 0 when its field was cached
+    long long firstHeapOperations = 0;
+
+    // the reverse Dijkstra from the finish
+    void buildField(FlowField& Field, const int FinishIndex) {
+        const int mapWidth = map.getWidth();
+        Field.levelMap.assign(map.getSize(), -1);
+        Field.directionsMap.assign(map.getSize(), FlowField::noDirection);
+        std::fill(closedNodesMap.begin(), closedNodesMap.end(), 0);
+        if(map.isObstacle(FinishIndex % mapWidth, FinishIndex / mapWidth)) { return; }
+
+        Field.levelMap[FinishIndex] = 0;
+        openNodes.push(NodeKey{0, FinishIndex});
+        while(!openNodes.empty()) {
+            const NodeKey n0 = openNodes.top();
+            openNodes.pop();
+            closedNodesMap[n0.index] = 1;
+            ++expandedNodes;
+            const int x = n0.index % mapWidth;
+            const int y = n0.index / mapWidth;
+            for(unsigned int moves = getFreeDirections(map.getNeighbourhood(x, y)) & Connectivity::mask; moves != 0;
+                moves &= moves - 1) {
+                const int i = lowestBit(moves);
+                const int childIndex = map.getIndex(x + dx[i], y + dy[i]);
+                if(closedNodesMap[childIndex] == 1) { continue; }
+
+                // the moves cost the same both ways, so the cost of child -> n0 is the cost of n0 -> child
+                const int m0Level = n0.priority + Connectivity::stepCost(i);
+                int& level = Field.levelMap[childIndex];
+                if(level == -1) { openNodes.push(NodeKey{m0Level, childIndex}); }
+                else if(m0Level < level) { openNodes.decreaseKey(NodeKey{m0Level, childIndex}); }
+                else { continue; }
+                level = m0Level;
+                Field.directionsMap[childIndex] = reverseDirection(i); // the next step of the child is n0
+            }
+        }
+    }
+public:
+    explicit FlowFieldPathFinder(const GridMap& Map, const int Capacity = 16)
+        : map(Map), capacity(std::max(Capacity, 1)), mapVersion(Map.getVersion()), closedNodesMap(Map.getSize()) {
+        openNodes.resize(Map.getWidth(), Map.getHeight());
+    }
+
+    const GridMap& getMap() const { return map; }
+    long long getExpandedNodes() const { return expandedNodes; }
+    long long getHeapOperations() const { return openNodes.getOperations() - firstHeapOperations; }
+    int getCachedFields() const { return fields.size(); }
+
+    // the flow field of a finish, from the cache or searched now
+    const FlowField& getField(const Position2D& Finish) {
+        expandedNodes = 0;
+        firstHeapOperations = openNodes.getOperations();
+        if(map.getVersion() != mapVersion) {
+            fields.clear();
+            mapVersion = map.getVersion();
+        }
+
+        const int finishIndex = map.getIndex(Finish);
+        typename std::unordered_map<int, FlowField>::iterator field = fields.find(finishIndex);
+        if(field == fields.end()) {
+            if(fields.size() >= capacity) {
+                typename std::unordered_map<int, FlowField>::iterator oldest = fields.begin();
+                for(typename std::unordered_map<int, FlowField>::iterator i = fields.begin(); i != fields.end(); ++i) {
+                    if(i->second.lastUse < oldest->second.lastUse) { oldest = i; }
+                }
+                fields.erase(oldest);
+            }
+            field = fields.emplace(finishIndex, FlowField()).first;
+            buildField(field->second, finishIndex);
+        }
+        field->second.lastUse = ++uses;
+        return field->second;
+    }
+
+    // the direction of the next step from a location to the finish. -1 at the finish or when there is no route
+    int nextDirection(const Position2D& From, const Position2D& Finish) {
+        const unsigned char direction = getField(Finish).directionsMap[map.getIndex(From)];
+        return direction == FlowField::noDirection ? -1 : direction;
+    }
+
+    // the whole route, walking over the flow field of the finish
+    Route findRoute(const Position2D& Start, const Position2D& Finish) {
+        const FlowField& field = getField(Finish);
+        Route path;
+        int index = map.getIndex(Start);
+        if(field.levelMap[index] == -1) { return path; } // no route
+        for(int j = field.directionsMap[index]; j != FlowField::noDirection; j = field.directionsMap[index]) {
+            path.append(j);
+            index += dy[j] * map.getWidth() + dx[j];
+        }
+        return path;
+    }
+
+    // the route as a string of direction digits
+    std::string pathFind(const Position2D& Start, const Position2D& Finish) { return findRoute(Start, Finish).toString(); }
+};
+
+#endif // _FLOWFIELDPATHFINDER_
@@ -0,0 +1,159 @@
+/**
+https://webdocs.cs.ualberta.ca/~holte/Publications/fringe.pdf
+Fringe Search: an A* without the node maps of the whole map, for the maps too big for them.
+It searches like IDA*, in iterations with a growing limit of F(n), but it keeps the fringe (the frontier of the last iteration), so
+an iteration goes on from the fringe of the last one instead of searching from the start again. A node over the limit stays in the
+fringe for the next iteration, the others are expanded and their children are visited right after them, in the same iteration.
+The state of the visited nodes (G(n) and the parent direction, packed in an int) lives in a compact hash table
+(GenerationHashMap.h, 12 bytes per slot), and the fringe is two arrays of (node, G(n)) entries, the nodes of this iteration
+and the ones kept for the next one. A node reached again with a better G(n) is added again, its old entry is skipped. So the
+memory of a search follows the nodes it visits and not the size of the map: 20 to 50 bytes per visited node with the empty
+slots of the table and the fringe, while the node maps of PathFinder are about 13 bytes per cell of the map. So the fringe
+search takes less memory when a query visits less than about a third of the map, and the memory of a big search is given back
+when the next one starts. An unreachable finish visits the whole region of the start, so the connected components of the map
+(setComponents) reject it without searching, like in PathFinder.
+The heuristics are the policies of PathFinder (Heuristics.h). With a consistent one (octile) the routes are optimal, like the ones of
+A*. The nodes are visited in the order of the fringe and not of F(n), so a search visits more nodes than A* and spends more time. */
+
+#ifndef _FRINGEPATHFINDER_
+#define _FRINGEPATHFINDER_
+
+#include <string>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include "GridMap.h"
+#include "Node.h"
+#include "Route.h"
+#include "Heuristics.h"
+#include "GenerationHashMap.h"
+#include "ConnectedComponents.h"
+
+// a node in the fringe, with its G(n) when it was added. the entry is old when the node has a better G(n) now
+struct FringeEntry {
+    int index;
+    int level;
+};
+
+template<class Heuristic = OctileHeuristic, class Connectivity = defaultConnectivity>
+class FringePathFinder {
+    static_assert(directions <= 8, "the parent direction is packed in 3 bits");
+private:
+    static const size_t keptCapacity = 1 << 16; // slots kept between the searches, a bigger table is given back
+
+    const GridMap& map;
+    Heuristic heuristic; // estimate of the remaining distance to the finish
+    ConnectedComponents<Connectivity>* components = nullptr; // to reject the unreachable finishes. optional
+    GenerationHashMap<int> cache; // the visited nodes, by their flattened index: G(n) << 3 | direction to the parent Node
+    std::vector<FringeEntry> nowList; // the fringe of this iteration, a stack: the children of a node are visited right after it
+    std::vector<FringeEntry> laterList; // the fringe of the next iteration
+    long long expandedNodes = 0; // nodes expanded by the last pathFind call
+    long long visitedNodes = 0; // nodes read from the fringe by the last pathFind call, expanded or not
+    int iterations = 0; // limits of F(n) tried by the last pathFind call
+    long long listOperations = 0; // insertions and removals of the fringe in the last pathFind call
+
+    // empty the cache and the fringe, and give back their memory when the last search made them big
+    void resetNodes() {
+        if(cache.getCapacity() > keptCapacity) { cache.release(); }
+        else { cache.clear(); }
+        if(nowList.capacity() > keptCapacity) { std::vector<FringeEntry>().swap(nowList); }
+        if(laterList.capacity() > keptCapacity) { std::vector<FringeEntry>().swap(laterList); }
+        nowList.clear();
+        laterList.clear();
+    }
+public:
+    explicit FringePathFinder(const GridMap& Map, const Heuristic& Estimate = Heuristic()) : map(Map), heuristic(Estimate) {}
+
+    const GridMap& getMap() const { return map; }
+    long long getExpandedNodes() const { return expandedNodes; }
+    long long getVisitedNodes() const { return visitedNodes; }
+    long long getHeapOperations() const { return listOperations; } // the fringe is the open list of this search
+    int getIterations() const { return iterations; }
+    size_t getCachedNodes() const { return cache.size(); } // nodes visited by the last search
+    // the bytes of the cache and the fringe, used by the last search
+    size_t getMemoryBytes() const {
+        return cache.getMemoryBytes() + (nowList.capacity() + laterList.capacity()) * sizeof(FringeEntry);
+    }
+    void setComponents(ConnectedComponents<Connectivity>* Components) { components = Components; }
+
+    // Fringe search. The route returned is in the compact (run-length) form
+    Route findRoute(const Position2D& Start, const Position2D& Finish) {
+        const int mapWidth = map.getWidth();
+        expandedNodes = 0;
+        visitedNodes = 0;
+        iterations = 0;
+        listOperations = 0;
+        resetNodes();
+        if(components != nullptr && !components->isConnected(Start, Finish)) { return Route(); } // no route, in O(1)
+
+        const int startIndex = map.getIndex(Start);
+        const int finishIndex = map.getIndex(Finish);
+        heuristic.setFinish(Finish);
+        cache.insert(startIndex, 0);
+        laterList.push_back(FringeEntry{startIndex, 0});
+        ++listOperations;
+        int limit = heuristic.estimate(Start.xPos, Start.yPos); // the limit of F(n) of the iteration
+
+        while(!laterList.empty()) {
+            ++iterations;
+            // the fringe kept by the last iteration, in the order it was kept
+            nowList.swap(laterList);
+            std::reverse(nowList.begin(), nowList.end());
+            int nextLimit = std::numeric_limits<int>::max(); // the lowest F(n) over the limit
+            while(!nowList.empty()) {
+                const FringeEntry entry = nowList.back();
+                nowList.pop_back();
+                ++listOperations;
+                const int node = *cache.find(entry.index);
+                if(node >> 3 != entry.level) { continue; } // an old entry, the node was added again with a better G(n)
+                const int x = entry.index % mapWidth;
+                const int y = entry.index / mapWidth;
+                ++visitedNodes;
+                const int priority = entry.level + heuristic.estimate(x, y);
+                if(priority > limit) { // kept for the next iteration
+                    nextLimit = std::min(nextLimit, priority);
+                    laterList.push_back(entry);
+                    ++listOperations;
+                    continue;
+                }
+
+                if(entry.index == finishIndex) {
+                    // generate the path from finish to start by following the directions, and reverse it
+                    Route path;
+                    for(int i = entry.index; i != startIndex; ) {
+                        const int j = *cache.find(i) & 7;
+                        path.append(reverseDirection(j));
+                        i += dy[j] * mapWidth + dx[j];
+                    }
+                    path.reverse();
+                    return path;
+                }
+
+                // expand the node: its children with a better G(n) are pushed on the fringe, they are visited next
+                ++expandedNodes;
+                for(unsigned int moves = getFreeDirections(map.getNeighbourhood(x, y)) & Connectivity::mask; moves != 0;
+                    moves &= moves - 1) {
+                    const int i = lowestBit(moves);
+                    const int childIndex = map.getIndex(x + dx[i], y + dy[i]);
+                    const int m0Level = entry.level + Connectivity::stepCost(i);
+                    const int child = m0Level << 3 | reverseDirection(i); // mark its parent Node direction
+                    bool inserted = false;
+                    int* childNode = cache.insert(childIndex, child, &inserted);
+                    if(!inserted) {
+                        if(*childNode >> 3 <= m0Level) { continue; }
+                        *childNode = child;
+                    }
+                    nowList.push_back(FringeEntry{childIndex, m0Level});
+                    ++listOperations;
+                }
+            }
+            limit = nextLimit;
+        }
+        return Route(); // no route found
+    }
+
+    // the route as a string of direction digits
+    std::string pathFind(const Position2D& Start, const Position2D& Finish) { return findRoute(Start, Finish).toString(); }
+};
+
+#endif // _FRINGEPATHFINDER_
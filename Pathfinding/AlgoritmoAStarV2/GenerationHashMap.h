@@ -0,0 +1,106 @@
+/**
+GenerationHashMap: a compact hash table of int values, for the searches keeping only the nodes they visit instead of maps of the
+whole map. The keys live in a flat array of slots (open addressing, linear probing), one slot is the key, the value and a generation
+stamp, 12 bytes with int keys and 16 with long long keys, without the allocations and pointers of std::unordered_map.
+Like GenerationMap, clear starts a new generation: the slots with an older stamp are empty, so clearing does not touch the slots.
+The table doubles when it is 3/4 full, and release gives the memory of a big search back. The values are not erased one by one,
+the searches write a value meaning "none" instead. */
+
+#ifndef _GENERATIONHASHMAP_
+#define _GENERATIONHASHMAP_
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+template<class Key>
+class GenerationHashMap {
+private:
+    struct Slot {
+        Key key;
+        int value;
+        unsigned int generation; // the slot is empty when it is not the current one
+    };
+
+    static const size_t minimumCapacity = 64; // a power of 2
+    std::vector<Slot> slots;
+    unsigned int generation = 1;
+    size_t count = 0; // keys of the current generation
+    int shift = 0; // 64 - log2(capacity)
+
+    size_t getSlot(const Key key) const {
+        return static_cast<size_t>(static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ull >> shift);
+    }
+
+    void allocate(const size_t Capacity) {
+        slots.assign(Capacity, Slot{Key(), 0, 0});
+        generation = 1;
+        count = 0;
+        shift = 64;
+        for(size_t c = Capacity; c > 1; c >>= 1) { --shift; }
+    }
+
+    // double the capacity, keeping the keys of the current generation
+    void grow() {
+        std::vector<Slot> old;
+        old.swap(slots);
+        const unsigned int oldGeneration = generation;
+        allocate(old.size() * 2);
+        for(const Slot& slot : old) {
+            if(slot.generation == oldGeneration) { insert(slot.key, slot.value); }
+        }
+    }
+public:
+    GenerationHashMap() { allocate(minimumCapacity); }
+
+    size_t size() const { return count; }
+    size_t getCapacity() const { return slots.size(); }
+    size_t getMemoryBytes() const { return slots.capacity() * sizeof(Slot); }
+
+    // empty the table. the stamps are only cleared when the counter wraps around
+    void clear() {
+        count = 0;
+        if(++generation == 0) {
+            for(Slot& slot : slots) { slot.generation = 0; }
+            generation = 1;
+        }
+    }
+
+    // empty the table and free its memory, back to the smallest capacity
+    void release() {
+        std::vector<Slot>().swap(slots);
+        allocate(minimumCapacity);
+    }
+
+    // the value of a key, nullptr when it is not in the table. the pointer is valid until the next insert
+    int* find(const Key key) {
+        for(size_t i = getSlot(key); ; i = (i + 1) & (slots.size() - 1)) {
+            Slot& slot = slots[i];
+            if(slot.generation != generation) { return nullptr; }
+            if(slot.key == key) { return &slot.value; }
+        }
+    }
+
+    const int* find(const Key key) const { return const_cast<GenerationHashMap*>(this)->find(key); }
+
+    /* the value of a key, inserted with Value when it is not in the table (Inserted is true then). the pointer is valid until
+    the next insert */
+    int* insert(const Key key, const int Value, bool* Inserted = nullptr) {
+        if((count + 1) * 4 > slots.size() * 3) { grow(); }
+        for(size_t i = getSlot(key); ; i = (i + 1) & (slots.size() - 1)) {
+            Slot& slot = slots[i];
+            if(slot.generation != generation) {
+                slot = Slot{key, Value, generation};
+                ++count;
+                if(Inserted != nullptr) { *Inserted = true; }
+                return &slot.value;
+            }
+            if(slot.key == key) {
+                if(Inserted != nullptr) { *Inserted = false; }
+                return &slot.value;
+            }
+        }
+    }
+};
+
+#endif // _GENERATIONHASHMAP_
@@ -0,0 +1,38 @@
+/**
+GenerationMap: per-cell generation stamps, so a pathfinder does not clear its node maps for every search. Every search starts a
+new generation, and a cell whose stamp is older holds the data of an old search: it is reset the first time the new search touches
+it (touch returns true). The setup cost of a search follows the nodes it visits instead of the size of the map. */
+
+#ifndef _GENERATIONMAP_
+#define _GENERATIONMAP_
+
+#include <vector>
+#include <algorithm>
+
+class GenerationMap {
+private:
+    std::vector<unsigned int> stamps; // generation of the last search touching every cell
+    unsigned int generation = 0;
+public:
+    void resize(const int Size) { stamps.assign(Size, 0); generation = 0; }
+
+    // start a new search. the stamps are only cleared when the counter wraps around
+    void nextGeneration() {
+        if(++generation == 0) {
+            std::fill(stamps.begin(), stamps.end(), 0);
+            generation = 1;
+        }
+    }
+
+    // the cell was touched by the current search
+    bool isCurrent(const int index) const { return stamps[index] == generation; }
+
+    // stamp the cell. true when it held the data of an old search and it has to be reset
+    bool touch(const int index) {
+        if(stamps[index] == generation) { return false; }
+        stamps[index] = generation;
+        return true;
+    }
+};
+
+#endif // _GENERATIONMAP_
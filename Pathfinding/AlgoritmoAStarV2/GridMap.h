@@ -0,0 +1,166 @@
+/**
+GridMap: the obstacle grid used by the pathfinders. The size is given at runtime and the cells are indexed in a flattened array
+(row * width + column), the index of the node maps of the pathfinders. The map is only read while searching, so many PathFinder
+objects can share the same GridMap.
+The obstacles are bits packed in 64-bit words, a row of words per row of the map, with a border of obstacle cells around the map
+(a sentinel). So the map takes one bit per cell, and the 3x3 neighbourhood of any cell of the map (getNeighbourhood) is read with a
+few shifts, without bounds checks. hasLineOfSight walks a straight line over the bits. Every change of the cells increments the
+version, so the pathfinders keeping data computed from the map (e.g. the flow fields) know when it is stale.
+The map is the only place where the obstacles are edited. The last changes of the obstacles are kept in a log with the version of
+every change (getChangesSince), so the pathfinders updating their data cell by cell (D* Lite, the connected components) catch up
+with the map on their next query, whoever edited it. When a pathfinder is further behind than the log goes, it computes its data
+again.
+The cells can also have a traversal cost (1 to 255, e.g. roads 1, grass 2, mud 5) in a layer of one byte per cell, allocated by the
+first setCost, so the maps without terrain do not pay for it. Entering a cell costs the 10/14 of the move times the cost of the
+cell. Only the PathFinder with the WeightedTerrain policy (Heuristics.h) reads the costs, the other pathfinders ignore them. */
+
+#ifndef _GRIDMAP_
+#define _GRIDMAP_
+
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdint>
+
+// a change of an obstacle cell, kept in the log of the map
+struct CellChange {
+    unsigned int version; // the version of the map after the change
+    int index;
+    bool obstacle; // the new value of the cell
+};
+
+struct Position2D{
+public:
+    int xPos, yPos;
+    Position2D(const int xPos, const int yPos) : xPos(xPos), yPos(yPos) {}
+    Position2D(const Position2D& Value) : Position2D(Value.xPos, Value.yPos) {}
+    Position2D& operator=(const Position2D& Value) { xPos = Value.xPos; yPos = Value.yPos; return *this; }
+    bool operator==(const Position2D& Other) const { return xPos == Other.xPos && yPos == Other.yPos; }
+};
+
+class GridMap {
+private:
+    std::vector<uint64_t> obstacleBits; // 1: obstacle. rows of rowWords words, with a border of obstacles
+    int width, height;
+    int rowWords; // words of a row: the width and the two border cells, and one more word for the reads crossing two words
+    unsigned int version = 0; // incremented by every change of the cells
+    std::vector<unsigned char> costs; // traversal cost of every cell. empty: all of them cost 1
+    std::vector<int> costCounts; // cells with every cost, to keep the minimum cost
+    int minimumCost = 1;
+    static const size_t changesLimit = 4096; // changes kept in the log. the oldest half is dropped when it is full
+    std::vector<CellChange> changes; // the last changes of the obstacles, the oldest first
+    unsigned int changesStart = 0; // every change of the obstacles after this version is in the log
+
+    void setBit(const int x, const int y, const bool Value) {
+        const int bit = getBitIndex(x, y);
+        if(Value) { obstacleBits[bit >> 6] |= uint64_t(1) << (bit & 63); }
+        else { obstacleBits[bit >> 6] &= ~(uint64_t(1) << (bit & 63)); }
+    }
+
+    // bit of the cell (x, y) of the map. the border cells are x or y = -1 and width or height
+    int getBitIndex(const int x, const int y) const { return (y + 1) * rowWords * 64 + x + 1; }
+
+    // three bits of a row starting at a column of the bordered grid
+    unsigned int getRowBits(const int row, const int column) const {
+        const uint64_t* words = &obstacleBits[row * rowWords + (column >> 6)];
+        const int shift = column & 63;
+        return static_cast<unsigned int>((words[0] >> shift | (words[1] << 1) << (63 - shift)) & 7);
+    }
+public:
+    GridMap(const int width, const int height) : width(width), height(height), rowWords((width + 2 + 63) / 64 + 1) {
+        obstacleBits.assign(static_cast<size_t>(height + 2) * rowWords, 0);
+        for(int x = -1; x <= width; ++x) {
+            setBit(x, -1, true);
+            setBit(x, height, true);
+        }
+        for(int y = 0; y < height; ++y) {
+            setBit(-1, y, true);
+            setBit(width, y, true);
+        }
+    }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getSize() const { return width * height; }
+    unsigned int getVersion() const { return version; }
+
+    // flattened index of a location. (y * width + x)
+    int getIndex(const int x, const int y) const { return y * width + x; }
+    int getIndex(const Position2D& Location) const { return getIndex(Location.xPos, Location.yPos); }
+
+    bool isInside(const int x, const int y) const { return x >= 0 && x < width && y >= 0 && y < height; }
+    // the border cells around the map (x or y = -1, width or height) are obstacles too
+    bool isObstacle(const int x, const int y) const {
+        const int bit = getBitIndex(x, y);
+        return (obstacleBits[bit >> 6] >> (bit & 63) & 1) != 0;
+    }
+    void setObstacle(const int x, const int y, const bool Value) {
+        const bool changed = isObstacle(x, y) != Value;
+        setBit(x, y, Value);
+        ++version;
+        if(!changed) { return; }
+        if(changes.size() >= changesLimit) {
+            changesStart = changes[changes.size() / 2 - 1].version;
+            changes.erase(changes.begin(), changes.begin() + changes.size() / 2);
+        }
+        changes.push_back(CellChange{version, getIndex(x, y), Value});
+    }
+
+    /* the changes of the obstacles after a version of the map, the oldest first. false when the log does not go back to that
+    version: the data computed from the map must be computed again */
+    bool getChangesSince(const unsigned int Version, std::vector<CellChange>& Changes) const {
+        Changes.clear();
+        if(Version < changesStart) { return false; }
+        std::vector<CellChange>::const_iterator first = std::upper_bound(changes.begin(), changes.end(), Version,
+            [](const unsigned int Value, const CellChange& Change) { return Value < Change.version; });
+        Changes.assign(first, changes.end());
+        return true;
+    }
+
+    /* the obstacles of the 3x3 cells around a cell of the map, bit (xd + 1) + 3 * (yd + 1) for the cell (x + xd, y + yd). the cells
+    out of the map are obstacles. getFreeDirections (Node.h) turns it into the directions a search can take */
+    unsigned int getNeighbourhood(const int x, const int y) const {
+        return getRowBits(y, x) | getRowBits(y + 1, x) << 3 | getRowBits(y + 2, x) << 6;
+    }
+
+    /* the straight line between the centers of two cells of the map crosses no obstacle. the cells of the line are the ones of
+    Bresenham's line from (x0, y0), integer only, and they follow each other by straight or diagonal steps, so the line can go
+    between two obstacles touching by a corner like the diagonal moves of the searches */
+    bool hasLineOfSight(int x0, int y0, const int x1, const int y1) const {
+        const int xd = std::abs(x1 - x0), yd = -std::abs(y1 - y0);
+        const int xs = x0 < x1 ? 1 : -1, ys = y0 < y1 ? 1 : -1;
+        for(int error = xd + yd; ; ) {
+            if(isObstacle(x0, y0)) { return false; }
+            if(x0 == x1 && y0 == y1) { return true; }
+            const int error2 = 2 * error;
+            if(error2 >= yd) { error += yd; x0 += xs; }
+            if(error2 <= xd) { error += xd; y0 += ys; }
+        }
+    }
+
+    int getCost(const int index) const { return costs.empty() ? 1 : costs[index]; }
+    int getCost(const int x, const int y) const { return getCost(getIndex(x, y)); }
+    int getMinimumCost() const { return minimumCost; } // the heuristics are scaled by it, so they never overestimate
+
+    // set the traversal cost of a cell, from 1 to 255
+    void setCost(const int x, const int y, const int Value) {
+        const int value = std::min(std::max(Value, 1), 255);
+        if(costs.empty()) {
+            costs.assign(getSize(), 1);
+            costCounts.assign(256, 0);
+            costCounts[1] = getSize();
+        }
+        unsigned char& cost = costs[getIndex(x, y)];
+        --costCounts[cost];
+        ++costCounts[value];
+        cost = value;
+        minimumCost = 1;
+        while(costCounts[minimumCost] == 0) { ++minimumCost; }
+        ++version;
+    }
+
+    // override () operator. 1 for an obstacle
+    unsigned char operator()(const int x, const int y) const { return isObstacle(x, y) ? 1 : 0; }
+};
+
+#endif // _GRIDMAP_
@@ -0,0 +1,244 @@
+/**
+Hash Distributed A* (HDA*): one query searched by many threads. https://www.aaai.org/ocs/index.php/ICAPS/ICAPS09/paper/view/724
+Every cell of the map is owned by one thread, given by a hash of the cell, and only its owner opens, expands and writes its node
+maps. A thread generating a child owned by another thread sends it as a message (the cell, its G(n) and its parent direction), and
+the owner opens it if it is better than what it had. So the threads never lock the node maps, and the work of one big search is
+spread over all of them.
+The messages go through single-producer single-consumer ring buffers, one per pair of threads, written and read with atomics only
+(lock-free). A full ring keeps the messages in an outbox of the sender until there is room.
+The first route found is not the best one yet: its cost is the incumbent, every thread drops the nodes with F(n) not lower than it,
+and a better route found later replaces it. The search ends when no thread has work and no message is in flight: a counter of the
+busy threads plus the messages not yet handled, which can not grow again once it is 0. With an admissible heuristic the incumbent is
+then optimal, the same cost as PathFinder (the route can be a different one of the same cost).
+The hash is of 8x8 blocks of cells, so most children belong to the thread of their parent and the threads send fewer messages.
+Every thread yields after a batch of expansions: with more threads than cores, a thread running for a whole time slice without the
+messages of the others expands many nodes which are opened again later with a better G(n). */
+
+#ifndef _HASHDISTRIBUTEDPATHFINDER_
+#define _HASHDISTRIBUTEDPATHFINDER_
+
+#include <string>
+#include <vector>
+#include <queue>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <limits>
+#include <algorithm>
+#include "GridMap.h"
+#include "Node.h"
+#include "Route.h"
+#include "GenerationMap.h"
+#include "Heuristics.h"
+
+// a node sent to the thread owning its cell
+struct NodeMessage {
+    int index;
+    int level; // G(n)
+    unsigned char direction; // direction to the parent Node
+};
+
+// lock-free ring buffer of messages from one thread to another
+class MessageRing {
+private:
+    static constexpr size_t capacity = 1024; // a power of 2
+    std::vector<NodeMessage> messages;
+    alignas(64) std::atomic<size_t> head; // next message to read, written by the receiver
+    alignas(64) std::atomic<size_t> tail; // next message to write, written by the sender
+public:
+    MessageRing() : messages(capacity), head(0), tail(0) {}
+
+    // sender side. false when the ring is full
+    bool push(const NodeMessage& Message) {
+        const size_t last = tail.load(std::memory_order_relaxed);
+        if(last - head.load(std::memory_order_acquire) == capacity) { return false; }
+        messages[last & (capacity - 1)] = Message;
+        tail.store(last + 1, std::memory_order_release);
+        return true;
+    }
+
+    // receiver side. false when the ring is empty
+    bool pop(NodeMessage& Message) {
+        const size_t first = head.load(std::memory_order_relaxed);
+        if(first == tail.load(std::memory_order_acquire)) { return false; }
+        Message = messages[first & (capacity - 1)];
+        head.store(first + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+template<class Heuristic = OctileHeuristic, class Connectivity = defaultConnectivity>
+class HashDistributedPathFinder {
+private:
+    static const int batchSize = 64; // expansions between two reads of the messages
+    static const int blockShift = 3; // the cells are hashed in blocks of 8x8
+
+    const GridMap& map;
+    const int threads;
+    Heuristic heuristic; // copied by every thread
+    std::vector<int> levelMap; // map of G(n) of the reached nodes, written by the owner of the cell
+    std::vector<unsigned char> directionsMap; // map of directions, written by the owner of the cell
+    GenerationMap nodeGenerations; // cells of the node maps written by the current search, stamped by their owners
+    std::vector<std::unique_ptr<MessageRing> > rings; // sender * threads + receiver
+    std::vector<long long> expandedNodes; // per thread, nodes expanded by the last pathFind call
+    std::vector<long long> heapOperations; // per thread, pushes and pops of its open list in the last pathFind call
+    std::vector<long long> sentMessages; // per thread, messages sent by the last pathFind call
+    std::atomic<int> incumbent; // cost of the best route found. max int: none
+    std::atomic<long long> pending; // busy threads and messages not handled yet. the search ends at 0
+
+    static long long sum(const std::vector<long long>& Counters) {
+        long long total = 0;
+        for(const long long counter : Counters) { total += counter; }
+        return total;
+    }
+
+    int getOwner(const int x, const int y) const {
+        const int blocksWide = (map.getWidth() >> blockShift) + 1;
+        const unsigned int block = static_cast<unsigned int>((y >> blockShift) * blocksWide + (x >> blockShift));
+        return static_cast<int>((block * 2654435761u >> 8) % threads);
+    }
+
+    void searchThread(const int Thread, const Position2D& Start, const Position2D& Finish) {
+        typedef std::priority_queue<NodeKey> OpenList; // a binary heap, the old entries are skipped when popped
+        const int mapWidth = map.getWidth();
+        const int finishIndex = map.getIndex(Finish);
+        Heuristic estimate(heuristic);
+        estimate.setFinish(Finish);
+        OpenList openNodes;
+        std::vector<std::deque<NodeMessage> > outboxes(threads); // the messages not fitting in their ring yet
+        int outboxMessages = 0;
+        long long expanded = 0, operations = 0, sent = 0; // the counters of the thread, kept when it ends
+        bool busy = true;
+
+        // open a node of this thread when it is better than the one it had
+        auto openNode = [&](const NodeMessage& Message) {
+            const int x = Message.index % mapWidth, y = Message.index / mapWidth;
+            const int priority = Message.level + estimate.estimate(x, y);
+            if(priority >= incumbent.load(std::memory_order_relaxed)) { return; }
+            if(!nodeGenerations.touch(Message.index) && levelMap[Message.index] <= Message.level) { return; }
+            levelMap[Message.index] = Message.level;
+            directionsMap[Message.index] = Message.direction;
+            openNodes.push(NodeKey{priority, Message.index});
+            ++operations;
+        };
+
+        if(getOwner(Start.xPos, Start.yPos) == Thread) { openNode(NodeMessage{map.getIndex(Start), 0, 0}); }
+        while(true) {
+            // read the messages of every thread
+            NodeMessage message;
+            for(int sender = 0; sender < threads; ++sender) {
+                MessageRing& ring = *rings[sender * threads + Thread];
+                while(ring.pop(message)) {
+                    if(!busy) {
+                        pending.fetch_add(1); // busy again before the message is counted as handled
+                        busy = true;
+                    }
+                    openNode(message);
+                    pending.fetch_sub(1);
+                }
+            }
+            for(int receiver = 0; receiver < threads && outboxMessages > 0; ++receiver) {
+                std::deque<NodeMessage>& outbox = outboxes[receiver];
+                while(!outbox.empty() && rings[Thread * threads + receiver]->push(outbox.front())) {
+                    outbox.pop_front();
+                    --outboxMessages;
+                }
+            }
+
+            // expand a batch of nodes
+            for(int expansions = 0; expansions < batchSize && !openNodes.empty(); ) {
+                const NodeKey n0 = openNodes.top();
+                openNodes.pop();
+                ++operations;
+                const int x = n0.index % mapWidth, y = n0.index / mapWidth;
+                const int n0Level = levelMap[n0.index];
+                if(n0.priority - estimate.estimate(x, y) > n0Level) { continue; } // an old entry of a reopened node
+                if(n0.priority >= incumbent.load(std::memory_order_relaxed)) { // no better route through the open nodes
+                    openNodes = OpenList();
+                    break;
+                }
+                if(n0.index == finishIndex) { // a better route, the incumbent
+                    int best = incumbent.load();
+                    while(n0Level < best && !incumbent.compare_exchange_weak(best, n0Level)) {}
+                    continue;
+                }
+                ++expansions;
+                ++expanded;
+
+                for(unsigned int moves = getFreeDirections(map.getNeighbourhood(x, y)) & Connectivity::mask; moves != 0;
+                    moves &= moves - 1) {
+                    const int i = lowestBit(moves);
+                    const int xdx = x + dx[i], ydy = y + dy[i];
+                    const NodeMessage child{map.getIndex(xdx, ydy), n0Level + Connectivity::stepCost(i),
+                        static_cast<unsigned char>(reverseDirection(i))};
+                    const int owner = getOwner(xdx, ydy);
+                    if(owner == Thread) {
+                        openNode(child);
+                        continue;
+                    }
+                    if(child.level + estimate.estimate(xdx, ydy) >= incumbent.load(std::memory_order_relaxed)) { continue; }
+                    pending.fetch_add(1); // counted before the receiver can handle it
+                    ++sent;
+                    if(!outboxes[owner].empty() || !rings[Thread * threads + owner]->push(child)) {
+                        outboxes[owner].push_back(child);
+                        ++outboxMessages;
+                    }
+                }
+            }
+
+            // without work, the thread waits for messages until every thread is idle
+            if(openNodes.empty() && outboxMessages == 0) {
+                if(busy) {
+                    busy = false;
+                    pending.fetch_sub(1);
+                }
+                if(pending.load() == 0) { break; }
+            }
+            std::this_thread::yield();
+        }
+        expandedNodes[Thread] = expanded;
+        heapOperations[Thread] = operations;
+        sentMessages[Thread] = sent;
+    }
+public:
+    HashDistributedPathFinder(const GridMap& Map, const int Threads, const Heuristic& Estimate = Heuristic())
+        : map(Map), threads(std::max(Threads, 1)), heuristic(Estimate), levelMap(Map.getSize()), directionsMap(Map.getSize()),
+        expandedNodes(threads), heapOperations(threads), sentMessages(threads), incumbent(0), pending(0) {
+        nodeGenerations.resize(Map.getSize());
+        for(int i = 0; i < threads * threads; ++i) { rings.emplace_back(new MessageRing()); }
+    }
+
+    const GridMap& getMap() const { return map; }
+    int getThreads() const { return threads; }
+    long long getExpandedNodes() const { return sum(expandedNodes); }
+    long long getHeapOperations() const { return sum(heapOperations); }
+    long long getSentMessages() const { return sum(sentMessages); }
+
+    // HDA* with all the threads. The route returned is in the compact (run-length) form
+    Route findRoute(const Position2D& Start, const Position2D& Finish) {
+        nodeGenerations.nextGeneration();
+        incumbent = std::numeric_limits<int>::max();
+        pending = threads;
+        std::vector<std::thread> workers;
+        for(int i = 0; i < threads; ++i) { workers.emplace_back(&HashDistributedPathFinder::searchThread, this, i, Start, Finish); }
+        for(std::thread& worker : workers) { worker.join(); }
+
+        // generate the path from finish to start by following the directions, and reverse it
+        Route path;
+        if(incumbent == std::numeric_limits<int>::max()) { return path; } // no route found
+        const int startIndex = map.getIndex(Start);
+        for(int index = map.getIndex(Finish); index != startIndex; ) {
+            const int j = directionsMap[index];
+            path.append(reverseDirection(j));
+            index += dy[j] * map.getWidth() + dx[j];
+        }
+        path.reverse();
+        return path;
+    }
+
+    // the route as a string of direction digits
+    std::string pathFind(const Position2D& Start, const Position2D& Finish) { return findRoute(Start, Finish).toString(); }
+};
+
+#endif // _HASHDISTRIBUTEDPATHFINDER_
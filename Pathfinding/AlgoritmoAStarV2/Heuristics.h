@@ -0,0 +1,78 @@
+/**
+Compile-time policies of PathFinder: the heuristic (estimate of the remaining distance, in the 10/14 cost units of nextLevel) and
+the connectivity (the moves tried from every location). They are small inline classes, so every PathFinder<Heuristic,
+Connectivity> instantiation is specialized and inlined by the compiler, and all of them can live in the same binary.
+A heuristic is told the finish once per search (setFinish) and then estimates the remaining distance from any location. The
+distance heuristics only keep the finish, other ones (Landmarks.h) keep precomputed data of the finish too.
+The connectivities walk the shared dx/dy tables, so the routes always use the same direction digits: with 8 directions the four
+connected search only tries the even (straight) ones.
+The terrain policy gives the cost of entering a cell. UniformTerrain is the 10/14 of the move, and it is compiled away, so the
+uniform searches do not pay for the terrain. WeightedTerrain multiplies it by the cost of the cell (GridMap::setCost) and scales the
+estimates by the minimum cost of the map, so they stay admissible and consistent.
+Octile is exact on an empty 8 connected map and Manhattan on an empty 4 connected one. Both are integer only and consistent, so
+the searches using them are optimal. Manhattan overestimates diagonal moves, Euclidean is truncated from sqrt. */
+
+#ifndef _HEURISTICS_
+#define _HEURISTICS_
+
+#include <math.h>
+#include <cstdlib>
+#include <algorithm>
+#include "GridMap.h"
+#include "Node.h"
+
+inline int manhattanDistance(const int xd, const int yd) { return 10 * (abs(xd) + abs(yd)); }
+inline int chebyshevDistance(const int xd, const int yd) { return 10 * std::max(abs(xd), abs(yd)); }
+// the original estimate of Node. Pitagoras: h^2=a^2+b^2
+inline int euclideanDistance(const int xd, const int yd) { return 10 * static_cast<int>(sqrt(xd * xd + yd * yd)); }
+
+// a heuristic which only depends on the distance to the finish
+template<int (*Distance)(int, int)>
+class DistanceHeuristic {
+private:
+    int xFinish = 0, yFinish = 0;
+public:
+    void setFinish(const Position2D& Finish) { xFinish = Finish.xPos; yFinish = Finish.yPos; }
+    int estimate(const int x, const int y) const { return Distance(xFinish - x, yFinish - y); }
+};
+
+typedef DistanceHeuristic<octileDistance> OctileHeuristic;
+typedef DistanceHeuristic<manhattanDistance> ManhattanHeuristic;
+typedef DistanceHeuristic<chebyshevDistance> ChebyshevHeuristic;
+typedef DistanceHeuristic<euclideanDistance> EuclideanHeuristic;
+
+// only the straight moves. stepCost is always 10
+struct FourConnected {
+    static const int step = directions / 4; // distance between two tried directions of dx/dy
+    static const unsigned int mask = directions == 8 ? 0x55 : 0x0F; // the tried directions, bit i for the direction i
+    static int stepCost(const int /*Direction*/) { return 10; }
+};
+
+#if directions==8
+// straight and diagonal moves, a diagonal move costs 14
+struct EightConnected {
+    static const int step = 1;
+    static const unsigned int mask = 0xFF;
+    static int stepCost(const int Direction) { return Direction % 2 == 0 ? 10 : 14; }
+};
+
+typedef EightConnected defaultConnectivity; // connectivity used by PathFinder<>
+#else
+typedef FourConnected defaultConnectivity;
+#endif // directions
+
+typedef EuclideanHeuristic defaultHeuristic; // heuristic used by PathFinder<>
+
+// every cell costs the same. the terrain used by PathFinder<>
+struct UniformTerrain {
+    static int stepCost(const GridMap& /*Map*/, const int /*Index*/, const int StepCost) { return StepCost; }
+    static int scaleEstimate(const GridMap& /*Map*/, const int Estimate) { return Estimate; }
+};
+
+// the traversal costs of the cells of the map
+struct WeightedTerrain {
+    static int stepCost(const GridMap& Map, const int Index, const int StepCost) { return StepCost * Map.getCost(Index); }
+    static int scaleEstimate(const GridMap& Map, const int Estimate) { return Estimate * Map.getMinimumCost(); }
+};
+
+#endif // _HEURISTICS_
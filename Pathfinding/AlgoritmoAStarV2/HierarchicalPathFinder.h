@@ -0,0 +1,436 @@
+/**
+https://webdocs.cs.ualberta.ca/~mmueller/ps/hpastar.pdf
+
+Hierarchical pathfinding A* (HPA*). The map is split in square clusters. Where two neighbour clusters share free border cells
+there are entrances: a pair of cells, one at every side of the border, joined by an inter-edge (straight, or diagonal where the
+cells only touch diagonally). The distances between the entrances
+of the same cluster are precomputed (intra-edges), so the entrances and the edges are a small abstract graph of the map.
+A long route is searched in the abstract graph, which only knows the entrances, and then every abstract segment is refined to
+real moves with a search limited to one cluster. The segments can be refined one by one when they are needed (abstractPath and
+refineSegment) or all at once (pathFind).
+When map cells change, updateCell marks the clusters the cell touches and only those clusters are rebuilt before the next query.
+The marked clusters are kept in lists, so a query without changes does not look at the clusters at all.
+HPA* routes are near-optimal: the route must pass through the entrances. */
+
+#ifndef _HIERARCHICALPATHFINDER_
+#define _HIERARCHICALPATHFINDER_
+
+#include <string>
+#include <vector>
+#include <queue>
+#include <functional>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdlib>
+#include "GridMap.h"
+#include "Node.h"
+#include "Route.h"
+
+class HierarchicalPathFinder {
+private:
+    struct Cluster {
+        std::vector<int> entrances; // entrance cells inside the cluster (flattened index)
+        std::vector<int> distances; // intra-edges. entrances x entrances distances, -1: not reachable inside the cluster
+        bool dirty = true; // the entrances and distances must be rebuilt
+    };
+
+    struct AbstractNode {
+        int level; // G(n)
+        int parent; // flattened index of the parent cell. -1 for the start
+        bool closed;
+    };
+
+    typedef std::pair<int, int> OpenEntry; // (priority, flattened index)
+
+    const GridMap& map;
+    const int clusterSize;
+    const int clustersWide, clustersHigh;
+    std::vector<Cluster> clusters;
+    std::vector<unsigned char> entranceMap; // bit per direction (index of dx/dy) with an inter-edge from the cell
+    std::vector<unsigned char> dirtyBordersMap; // per cluster, bit 0: east border, 1: south border, 2: south-east corner to rebuild
+    std::vector<int> dirtyBorders; // the clusters with some bit in dirtyBordersMap
+    std::vector<int> dirtyClusters; // the clusters marked dirty
+    std::vector<int> clusterLevels; // scratch of the cluster searches. G(n) per cell of the cluster, -1: not reached
+    std::vector<unsigned char> clusterDirections; // scratch of the cluster searches. direction to the parent cell
+    long long expandedNodes = 0; // abstract and cluster nodes expanded by the last query
+    long long heapOperations = 0; // pushes and pops of the abstract and cluster searches of the last query
+
+    int getCluster(const int x, const int y) const { return (y / clusterSize) * clustersWide + x / clusterSize; }
+    int getClusterX(const int cluster) const { return (cluster % clustersWide) * clusterSize; }
+    int getClusterY(const int cluster) const { return (cluster / clustersWide) * clusterSize; }
+    int getClusterWidth(const int cluster) const { return std::min(clusterSize, map.getWidth() - getClusterX(cluster)); }
+    int getClusterHeight(const int cluster) const { return std::min(clusterSize, map.getHeight() - getClusterY(cluster)); }
+
+    void markCluster(const int cluster) {
+        if(clusters[cluster].dirty) { return; }
+        clusters[cluster].dirty = true;
+        dirtyClusters.push_back(cluster);
+    }
+
+    void markBorders(const int cluster, const unsigned char Borders) {
+        if(dirtyBordersMap[cluster] == 0) { dirtyBorders.push_back(cluster); }
+        dirtyBordersMap[cluster] |= Borders;
+    }
+
+    /* Dijkstra from a cell limited to its cluster. Fills clusterLevels (local index) and clusterDirections. Stops when the
+    target cell is closed, or explores the whole cluster when Target is -1. Returns the distance to the target or -1 */
+    int searchCluster(const Position2D& From, const int Target) {
+        const int cluster = getCluster(From.xPos, From.yPos);
+        const int x0 = getClusterX(cluster);
+        const int y0 = getClusterY(cluster);
+        const int width = getClusterWidth(cluster);
+        const int height = getClusterHeight(cluster);
+        std::fill(clusterLevels.begin(), clusterLevels.end(), -1);
+
+        std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<OpenEntry> > pq;
+        const int fromLocal = (From.yPos - y0) * clusterSize + From.xPos - x0;
+        clusterLevels[fromLocal] = 0;
+        pq.push(OpenEntry(0, fromLocal));
+        ++heapOperations;
+        while(!pq.empty()) {
+            const OpenEntry n0 = pq.top();
+            pq.pop();
+            ++heapOperations;
+            if(n0.first != clusterLevels[n0.second]) { continue; } // stale entry
+            const int x = x0 + n0.second % clusterSize;
+            const int y = y0 + n0.second / clusterSize;
+            ++expandedNodes;
+            if(map.getIndex(x, y) == Target) { return n0.first; }
+
+            for(int i = 0; i < directions; ++i) {
+                const int xdx = x + dx[i];
+                const int ydy = y + dy[i];
+                if(xdx < x0 || xdx >= x0 + width || ydy < y0 || ydy >= y0 + height || map.isObstacle(xdx, ydy)) { continue; }
+                const int childLocal = (ydy - y0) * clusterSize + xdx - x0;
+                const int childLevel = n0.first + (directions == 8 && i % 2 == 1 ? 14 : 10);
+                if(clusterLevels[childLocal] == -1 || clusterLevels[childLocal] > childLevel) {
+                    clusterLevels[childLocal] = childLevel;
+                    clusterDirections[childLocal] = reverseDirection(i);
+                    pq.push(OpenEntry(childLevel, childLocal));
+                    ++heapOperations;
+                }
+            }
+        }
+        return -1;
+    }
+
+    // distance found by the last searchCluster to a cell of the same cluster
+    int getClusterLevel(const int Cluster, const int Index) const {
+        const int x = Index % map.getWidth() - getClusterX(Cluster);
+        const int y = Index / map.getWidth() - getClusterY(Cluster);
+        return clusterLevels[y * clusterSize + x];
+    }
+
+    // index of the direction (xs, ys) in dx/dy. -1 when the move is not allowed
+    static int findDirection(const int xs, const int ys) {
+        for(int i = 0; i < directions; ++i) {
+            if(dx[i] == xs && dy[i] == ys) { return i; }
+        }
+        return -1;
+    }
+
+    bool isFree(const int x, const int y) const { return map.isInside(x, y) && !map.isObstacle(x, y); }
+
+    // set or clear the inter-edge between two neighbour cells of different clusters
+    void setTransition(const int x, const int y, const int Direction, const bool Value) {
+        unsigned char& from = entranceMap[map.getIndex(x, y)];
+        unsigned char& to = entranceMap[map.getIndex(x + dx[Direction], y + dy[Direction])];
+        const unsigned char fromBit = 1 << Direction;
+        const unsigned char toBit = 1 << reverseDirection(Direction);
+        from = Value ? from | fromBit : from & ~fromBit;
+        to = Value ? to | toBit : to & ~toBit;
+    }
+
+    /* entrances of one border. Vertical: between the cluster and its east neighbour, otherwise its south neighbour.
+    Every run of free cell pairs gets one entrance in the middle, or two at its ends when the run is long (6 or more cells).
+    With 8 directions two cells can also be joined only diagonally across the border, that pair gets its own entrance */
+    void buildBorder(const int cluster, const bool Vertical) {
+        const int length = Vertical ? getClusterHeight(cluster) : getClusterWidth(cluster);
+        const int x0 = Vertical ? getClusterX(cluster) + getClusterWidth(cluster) - 1 : getClusterX(cluster);
+        const int y0 = Vertical ? getClusterY(cluster) : getClusterY(cluster) + getClusterHeight(cluster) - 1;
+        const int xStep = Vertical ? 0 : 1;
+        const int yStep = Vertical ? 1 : 0;
+        const int across = findDirection(Vertical ? 1 : 0, Vertical ? 0 : 1); // E or S
+        const int acrossForward = findDirection(dx[across] + xStep, dy[across] + yStep); // SE, -1 with 4 directions
+        const int acrossBackward = findDirection(dx[across] - xStep, dy[across] - yStep); // NE or SW
+        const auto pairFree = [&](const int k) {
+            const int x = x0 + xStep * k;
+            const int y = y0 + yStep * k;
+            return k >= 0 && k < length && !map.isObstacle(x, y) && !map.isObstacle(x + dx[across], y + dy[across]);
+        };
+
+        // clear the old entrances of the border
+        for(int k = 0; k < length; ++k) {
+            setTransition(x0 + xStep * k, y0 + yStep * k, across, false);
+            if(acrossForward != -1 && k + 1 < length) {
+                setTransition(x0 + xStep * k, y0 + yStep * k, acrossForward, false);
+                setTransition(x0 + xStep * (k + 1), y0 + yStep * (k + 1), acrossBackward, false);
+            }
+        }
+
+        int runStart = -1;
+        for(int k = 0; k <= length; ++k) {
+            const bool free = pairFree(k);
+            if(free && runStart == -1) { runStart = k; }
+            if(free || runStart == -1) { continue; }
+
+            const int runEnd = k - 1;
+            const int transitions[2] = {runEnd - runStart + 1 < 6 ? (runStart + runEnd) / 2 : runStart, runEnd};
+            const int transitionsCount = runEnd - runStart + 1 < 6 ? 1 : 2;
+            for(int t = 0; t < transitionsCount; ++t) {
+                setTransition(x0 + xStep * transitions[t], y0 + yStep * transitions[t], across, true);
+            }
+            runStart = -1;
+        }
+
+        // diagonal pairs where neither straight pair is free
+        for(int k = 0; acrossForward != -1 && k + 1 < length; ++k) {
+            if(pairFree(k) || pairFree(k + 1)) { continue; }
+            const int x = x0 + xStep * k;
+            const int y = y0 + yStep * k;
+            if(isFree(x, y) && isFree(x + dx[acrossForward], y + dy[acrossForward])) { setTransition(x, y, acrossForward, true); }
+            const int xNext = x + xStep;
+            const int yNext = y + yStep;
+            if(isFree(xNext, yNext) && isFree(xNext + dx[acrossBackward], yNext + dy[acrossBackward])) {
+                setTransition(xNext, yNext, acrossBackward, true);
+            }
+        }
+    }
+
+    /* the four clusters around the south-east corner of a cluster. With 8 directions the corner cells can only be joined
+    diagonally when the two other cells of the corner are blocked */
+    void buildCorner(const int cluster) {
+        const int se = findDirection(1, 1);
+        const int sw = findDirection(-1, 1);
+        if(se == -1) { return; }
+        const int x = getClusterX(cluster) + getClusterWidth(cluster) - 1;
+        const int y = getClusterY(cluster) + getClusterHeight(cluster) - 1;
+        const bool nw = isFree(x, y), ne = isFree(x + 1, y), swFree = isFree(x, y + 1), seFree = isFree(x + 1, y + 1);
+        setTransition(x, y, se, nw && seFree && !ne && !swFree);
+        setTransition(x + 1, y, sw, ne && swFree && !nw && !seFree);
+    }
+
+    // entrance list and intra-edges of a cluster
+    void buildCluster(const int cluster) {
+        Cluster& c = clusters[cluster];
+        const int x0 = getClusterX(cluster);
+        const int y0 = getClusterY(cluster);
+        c.entrances.clear();
+        for(int y = y0; y < y0 + getClusterHeight(cluster); ++y) {
+            for(int x = x0; x < x0 + getClusterWidth(cluster); ++x) {
+                if(entranceMap[map.getIndex(x, y)] != 0) { c.entrances.push_back(map.getIndex(x, y)); }
+            }
+        }
+
+        const int count = c.entrances.size();
+        c.distances.assign(count * count, -1);
+        for(int i = 0; i < count; ++i) {
+            const int from = c.entrances[i];
+            searchCluster(Position2D(from % map.getWidth(), from / map.getWidth()), -1);
+            for(int j = 0; j < count; ++j) { c.distances[i * count + j] = getClusterLevel(cluster, c.entrances[j]); }
+        }
+        c.dirty = false;
+    }
+
+    // position of an entrance in the list of its cluster
+    static int findEntrance(const Cluster& c, const int Index) {
+        return std::find(c.entrances.begin(), c.entrances.end(), Index) - c.entrances.begin();
+    }
+public:
+    HierarchicalPathFinder(const GridMap& Map, const int ClusterSize = 10)
+        : map(Map), clusterSize(ClusterSize), clustersWide((Map.getWidth() + ClusterSize - 1) / ClusterSize),
+        clustersHigh((Map.getHeight() + ClusterSize - 1) / ClusterSize), clusters(clustersWide * clustersHigh),
+        entranceMap(Map.getSize(), 0), dirtyBordersMap(clustersWide * clustersHigh, 7),
+        clusterLevels(ClusterSize * ClusterSize), clusterDirections(ClusterSize * ClusterSize) {
+        // all the clusters and their borders are built the first time
+        for(int cluster = 0; cluster < static_cast<int>(clusters.size()); ++cluster) {
+            dirtyBorders.push_back(cluster);
+            dirtyClusters.push_back(cluster);
+        }
+        rebuildDirtyClusters();
+    }
+
+    const GridMap& getMap() const { return map; }
+    long long getExpandedNodes() const { return expandedNodes; }
+    long long getHeapOperations() const { return heapOperations; }
+    int getClusterSize() const { return clusterSize; }
+
+    // number of entrances (nodes of the abstract graph)
+    int getAbstractNodes() const {
+        int count = 0;
+        for(const Cluster& c : clusters) { count += c.entrances.size(); }
+        return count;
+    }
+
+    // a map cell has changed. Its cluster and the clusters on the other side of its borders are rebuilt before the next query
+    void updateCell(const int x, const int y) {
+        const int cluster = getCluster(x, y);
+        const int cx = cluster % clustersWide;
+        const int cy = cluster / clustersWide;
+        const bool onEast = x == getClusterX(cluster) + getClusterWidth(cluster) - 1 && cx + 1 < clustersWide;
+        const bool onWest = x == getClusterX(cluster) && cx > 0;
+        const bool onSouth = y == getClusterY(cluster) + getClusterHeight(cluster) - 1 && cy + 1 < clustersHigh;
+        const bool onNorth = y == getClusterY(cluster) && cy > 0;
+        markCluster(cluster);
+        if(onEast) { markBorders(cluster, 1); markCluster(cluster + 1); }
+        if(onWest) { markBorders(cluster - 1, 1); markCluster(cluster - 1); }
+        if(onSouth) { markBorders(cluster, 2); markCluster(cluster + clustersWide); }
+        if(onNorth) { markBorders(cluster - clustersWide, 2); markCluster(cluster - clustersWide); }
+        if((onEast || onWest) && (onSouth || onNorth)) {
+            // the corner is kept by the north-west cluster of the four
+            const int corner = cluster - (onWest ? 1 : 0) - (onNorth ? clustersWide : 0);
+            markBorders(corner, 4);
+            markCluster(corner);
+            markCluster(corner + 1);
+            markCluster(corner + clustersWide);
+            markCluster(corner + clustersWide + 1);
+        }
+    }
+
+    // rebuild the borders and the clusters marked by updateCell. Done by every query too. Returns the rebuilt clusters
+    int rebuildDirtyClusters() {
+        for(const int cluster : dirtyBorders) {
+            const bool east = cluster % clustersWide + 1 < clustersWide;
+            const bool south = cluster / clustersWide + 1 < clustersHigh;
+            if(east && (dirtyBordersMap[cluster] & 1) != 0) { buildBorder(cluster, true); }
+            if(south && (dirtyBordersMap[cluster] & 2) != 0) { buildBorder(cluster, false); }
+            if(east && south && (dirtyBordersMap[cluster] & 4) != 0) { buildCorner(cluster); }
+            dirtyBordersMap[cluster] = 0;
+        }
+        dirtyBorders.clear();
+        for(const int cluster : dirtyClusters) { buildCluster(cluster); }
+        const int rebuilt = dirtyClusters.size();
+        dirtyClusters.clear();
+        return rebuilt;
+    }
+
+    /* A* in the abstract graph. The start and the finish are linked to the entrances of their clusters (and to each other when
+    they share the cluster) with two cluster searches. Returns the waypoints from Start to Finish, empty when there is no route */
+    std::vector<Position2D> abstractPath(const Position2D& Start, const Position2D& Finish) {
+        rebuildDirtyClusters();
+        expandedNodes = 0;
+        heapOperations = 0;
+        std::vector<Position2D> waypoints;
+        if(map.isObstacle(Start.xPos, Start.yPos) || map.isObstacle(Finish.xPos, Finish.yPos)) { return waypoints; }
+
+        const int mapWidth = map.getWidth();
+        const int startIndex = map.getIndex(Start);
+        const int finishIndex = map.getIndex(Finish);
+        const int startCluster = getCluster(Start.xPos, Start.yPos);
+        const int finishCluster = getCluster(Finish.xPos, Finish.yPos);
+        const Cluster& sc = clusters[startCluster];
+        const Cluster& fc = clusters[finishCluster];
+
+        // temporary edges of the start and the finish
+        searchCluster(Start, -1);
+        std::vector<int> startDistances(sc.entrances.size());
+        for(size_t i = 0; i < sc.entrances.size(); ++i) { startDistances[i] = getClusterLevel(startCluster, sc.entrances[i]); }
+        const int directDistance = startCluster == finishCluster ? getClusterLevel(startCluster, finishIndex) : -1;
+        searchCluster(Finish, -1);
+        std::vector<int> finishDistances(fc.entrances.size());
+        for(size_t i = 0; i < fc.entrances.size(); ++i) { finishDistances[i] = getClusterLevel(finishCluster, fc.entrances[i]); }
+
+        std::unordered_map<int, AbstractNode> nodes;
+        std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<OpenEntry> > openNodes;
+        const auto reach = [&](const int Index, const int Parent, const int Level) {
+            auto found = nodes.find(Index);
+            if(found != nodes.end() && (found->second.closed || found->second.level <= Level)) { return; }
+            nodes[Index] = AbstractNode{Level, Parent, false};
+            const int estimate = octileDistance(Finish.xPos - Index % mapWidth, Finish.yPos - Index / mapWidth);
+            openNodes.push(OpenEntry(Level + estimate, Index));
+            ++heapOperations;
+        };
+
+        reach(startIndex, -1, 0);
+        while(!openNodes.empty()) {
+            const int index = openNodes.top().second;
+            openNodes.pop();
+            ++heapOperations;
+            AbstractNode& n0 = nodes[index];
+            if(n0.closed) { continue; } // stale entry
+            n0.closed = true;
+            const int level = n0.level;
+            ++expandedNodes;
+
+            if(index == finishIndex) {
+                for(int i = index; i != -1; i = nodes[i].parent) { waypoints.push_back(Position2D(i % mapWidth, i / mapWidth)); }
+                std::reverse(waypoints.begin(), waypoints.end());
+                return waypoints;
+            }
+
+            if(index == startIndex) {
+                for(size_t i = 0; i < sc.entrances.size(); ++i) {
+                    if(startDistances[i] != -1) { reach(sc.entrances[i], index, startDistances[i]); }
+                }
+                if(directDistance != -1) { reach(finishIndex, index, directDistance); }
+            }
+
+            const unsigned char sides = entranceMap[index];
+            if(sides == 0) { continue; }
+
+            // intra-edges, inter-edges and the edge to the finish
+            const int cluster = getCluster(index % mapWidth, index / mapWidth);
+            const Cluster& c = clusters[cluster];
+            const int count = c.entrances.size();
+            const int slot = findEntrance(c, index);
+            for(int j = 0; j < count; ++j) {
+                const int distance = c.distances[slot * count + j];
+                if(j != slot && distance != -1) { reach(c.entrances[j], index, level + distance); }
+            }
+            for(int i = 0; i < directions; ++i) {
+                if((sides & (1 << i)) == 0) { continue; }
+                const int neighbour = map.getIndex(index % mapWidth + dx[i], index / mapWidth + dy[i]);
+                reach(neighbour, index, level + (directions == 8 && i % 2 == 1 ? 14 : 10));
+            }
+            if(cluster == finishCluster) {
+                const int distance = finishDistances[findEntrance(fc, index)];
+                if(distance != -1) { reach(finishIndex, index, level + distance); }
+            }
+        }
+        return waypoints; // no route found
+    }
+
+    // real moves between two consecutive waypoints of abstractPath. The route returned is in the compact form
+    Route refineSegment(const Position2D& From, const Position2D& To) {
+        const int xd = To.xPos - From.xPos;
+        const int yd = To.yPos - From.yPos;
+        if(getCluster(From.xPos, From.yPos) != getCluster(To.xPos, To.yPos)) {
+            // inter-edge: one straight move across the border
+            for(int i = 0; i < directions; ++i) {
+                if(dx[i] == xd && dy[i] == yd) {
+                    Route path;
+                    path.append(i);
+                    return path;
+                }
+            }
+            return Route();
+        }
+
+        const int cluster = getCluster(From.xPos, From.yPos);
+        if(searchCluster(From, map.getIndex(To)) == -1) { return Route(); }
+        Route path;
+        int x = To.xPos;
+        int y = To.yPos;
+        while(!(x == From.xPos && y == From.yPos)) {
+            const int j = clusterDirections[(y - getClusterY(cluster)) * clusterSize + x - getClusterX(cluster)];
+            path.append(reverseDirection(j));
+            x += dx[j];
+            y += dy[j];
+        }
+        path.reverse();
+        return path;
+    }
+
+    // HPA*. The abstract route refined to real moves. The route returned is in the compact form, like PathFinder::findRoute
+    Route findRoute(const Position2D& Start, const Position2D& Finish) {
+        const std::vector<Position2D> waypoints = abstractPath(Start, Finish);
+        Route path;
+        for(size_t i = 1; i < waypoints.size(); ++i) { path.append(refineSegment(waypoints[i - 1], waypoints[i])); }
+        return path;
+    }
+
+    // the route as a string of direction digits
+    std::string pathFind(const Position2D& Start, const Position2D& Finish) { return findRoute(Start, Finish).toString(); }
+};
+
+#endif // _HIERARCHICALPATHFINDER_
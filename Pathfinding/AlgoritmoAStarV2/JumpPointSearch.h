@@ -0,0 +1,238 @@
+/**
+http://users.cecs.anu.edu.au/~dharabor/data/papers/harabor-grastien-aaai11.pdf
+http://www.gameaipro.com/GameAIPro2/GameAIPro2_Chapter14_JPS_Plus_An_Extreme_A_Star_Speed_Optimization_for_Static_Uniform_Cost_Grids.pdf
+
+Jump Point Search (JPS) is an A* for uniform-cost 8-connected grids. Many paths of a grid are symmetric (the same moves in a
+different order), so instead of pushing every neighbour the search "jumps" straight or diagonally until it finds a jump point: a
+cell with a forced neighbour (a neighbour that can only be reached optimally through that cell) or the goal. Only the jump points
+are pushed into the open list.
+JPS+ precomputes for every cell and direction the distance to the next jump point (positive) or to the next wall (zero or
+negative), so a jump is a table lookup. The table must be computed again with precomputeJumps when the map changes.
+
+The diagonal moves follow the GridMap rules of PathFinder: a diagonal move only needs the destination cell to be free. */
+
+#ifndef _JUMPPOINTSEARCH_
+#define _JUMPPOINTSEARCH_
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include "GridMap.h"
+#include "Node.h"
+#include "Route.h"
+#include "OpenList.h"
+#include "GenerationMap.h"
+
+class JumpPointPathFinder {
+    static_assert(directions == 8, "Jump Point Search needs 8 directions");
+private:
+    const GridMap& map;
+    const bool precomputedJumps; // true: JPS+, false: JPS
+    std::vector<std::int16_t> jumpDistances; // JPS+ table. directions values per cell
+    std::vector<int> levelMap; // G(n) of the reached jump points. -1: not reached
+    std::vector<unsigned char> closedNodesMap; // map of closed (tried-out) nodes
+    GenerationMap nodeGenerations; // cells of levelMap and closedNodesMap written by the current search
+    std::vector<int> parentMap; // map of the parent jump point (flattened index)
+    std::vector<unsigned char> directionsMap; // map of the direction used to arrive to the jump point
+    IndexedHeapOpenList openNodes; // list of open (not-yet-tried) nodes
+    long long expandedNodes = 0; // nodes expanded by the last pathFind call
+    long long firstHeapOperations = 0; // operations of the open list before the last pathFind call
+
+    bool isFree(const int x, const int y) const { return map.isInside(x, y) && !map.isObstacle(x, y); }
+
+    // clear the Node maps of a cell the first time the current search touches it
+    void touchNode(const int index) {
+        if(nodeGenerations.touch(index)) {
+            levelMap[index] = -1;
+            closedNodesMap[index] = 0;
+        }
+    }
+
+    static int estimate(const int x, const int y, const Position2D& Finish) {
+        return octileDistance(Finish.xPos - x, Finish.yPos - y);
+    }
+
+    // a cell reached moving in the direction has a forced neighbour
+    bool hasForcedNeighbour(const int x, const int y, const int Direction) const {
+        const int xs = dx[Direction];
+        const int ys = dy[Direction];
+        if(xs != 0 && ys != 0) {
+            return (isFree(x - xs, y + ys) && !isFree(x - xs, y)) || (isFree(x + xs, y - ys) && !isFree(x, y - ys));
+        }
+        if(xs != 0) { return (isFree(x + xs, y + 1) && !isFree(x, y + 1)) || (isFree(x + xs, y - 1) && !isFree(x, y - 1)); }
+        return (isFree(x + 1, y + ys) && !isFree(x + 1, y)) || (isFree(x - 1, y + ys) && !isFree(x - 1, y));
+    }
+
+    // JPS. steps in the direction until a jump point, the goal or a wall. returns the number of steps or 0
+    int jump(int x, int y, const int Direction, const Position2D& Finish) const {
+        const bool diagonal = Direction % 2 == 1;
+        for(int steps = 1; ; ++steps) {
+            x += dx[Direction];
+            y += dy[Direction];
+            if(!isFree(x, y)) { return 0; }
+            if((x == Finish.xPos && y == Finish.yPos) || hasForcedNeighbour(x, y, Direction)) { return steps; }
+            // a diagonal jump stops where one of its straight components finds something
+            if(diagonal && (jump(x, y, (Direction + 7) % 8, Finish) > 0 || jump(x, y, (Direction + 1) % 8, Finish) > 0)) {
+                return steps;
+            }
+        }
+    }
+
+    // JPS+. the same as jump but reading the table. the goal is found when it is in the direction before the jump point or wall
+    int jumpPrecomputed(const int x, const int y, const int Direction, const Position2D& Finish) const {
+        const int distance = jumpDistances[map.getIndex(x, y) * directions + Direction];
+        const int reach = abs(distance); // free steps in the direction before the jump point or wall
+        const int xd = Finish.xPos - x;
+        const int yd = Finish.yPos - y;
+        const int xs = dx[Direction];
+        const int ys = dy[Direction];
+        if(xs != 0 && ys != 0) {
+            // goal in the quadrant of the diagonal: stop on the row or column of the goal
+            if((xd > 0) == (xs > 0) && (yd > 0) == (ys > 0) && xd != 0 && yd != 0) {
+                const int steps = std::min(abs(xd), abs(yd));
+                if(steps <= reach) { return steps; }
+            }
+        }
+        else if((xs == 0 ? xd == 0 && (yd > 0) == (ys > 0) && yd != 0 : yd == 0 && (xd > 0) == (xs > 0) && xd != 0)) {
+            const int steps = abs(xd) + abs(yd);
+            if(steps <= reach) { return steps; }
+        }
+        return std::max(distance, 0);
+    }
+
+    // search every direction a jump point has to look at, given the direction used to arrive to it (pruned neighbours)
+    void expand(const int x, const int y, const int level, const bool isStart, const Position2D& Finish) {
+        const int arrival = directionsMap[map.getIndex(x, y)];
+        for(int i = 0; i < directions; ++i) {
+            if(!isStart) {
+                const int turn = (i - arrival + directions) % directions; // 0: straight on, 1 and 7: 45 degrees...
+                const bool diagonalArrival = arrival % 2 == 1;
+                if(turn == 1 || turn == 7) {
+                    // natural neighbours of a diagonal move. forced neighbours of a straight move when the side is blocked
+                    const int side = (arrival + (turn == 1 ? 2 : 6)) % directions;
+                    if(!diagonalArrival && isFree(x + dx[side], y + dy[side])) { continue; }
+                }
+                else if(turn == 2 || turn == 6) {
+                    // forced neighbours of a diagonal move when the opposite side is blocked
+                    const int side = (arrival + (turn == 2 ? 3 : 5)) % directions;
+                    if(!diagonalArrival || isFree(x + dx[side], y + dy[side])) { continue; }
+                }
+                else if(turn != 0) { continue; }
+            }
+
+            const int steps = precomputedJumps ? jumpPrecomputed(x, y, i, Finish) : jump(x, y, i, Finish);
+            if(steps == 0) { continue; }
+
+            const int xj = x + dx[i] * steps;
+            const int yj = y + dy[i] * steps;
+            const int jumpIndex = map.getIndex(xj, yj);
+            touchNode(jumpIndex);
+            if(closedNodesMap[jumpIndex] == 1) { continue; }
+
+            const int jumpLevel = level + steps * (i % 2 == 0 ? 10 : 14);
+            int& reachedLevel = levelMap[jumpIndex];
+            if(reachedLevel != -1 && reachedLevel <= jumpLevel) { continue; }
+
+            const NodeKey m0{jumpLevel + estimate(xj, yj, Finish), jumpIndex};
+            if(reachedLevel == -1) { openNodes.push(m0); }
+            else { openNodes.decreaseKey(m0); }
+            reachedLevel = jumpLevel;
+            parentMap[jumpIndex] = map.getIndex(x, y);
+            directionsMap[jumpIndex] = i;
+        }
+    }
+public:
+    JumpPointPathFinder(const GridMap& Map, const bool PrecomputedJumps)
+        : map(Map), precomputedJumps(PrecomputedJumps), levelMap(Map.getSize()), closedNodesMap(Map.getSize()),
+        parentMap(Map.getSize()), directionsMap(Map.getSize()) {
+        openNodes.resize(Map.getWidth(), Map.getHeight());
+        nodeGenerations.resize(Map.getSize());
+        if(precomputedJumps) { precomputeJumps(); }
+    }
+
+    const GridMap& getMap() const { return map; }
+    long long getExpandedNodes() const { return expandedNodes; }
+    long long getHeapOperations() const { return openNodes.getOperations() - firstHeapOperations; }
+
+    /* JPS+ table. Every cell is computed from the next cell in the same direction, so the cells are visited from the far side.
+    Distances that do not fit in 16 bits become a jump point, which only adds one more node to the search */
+    void precomputeJumps() {
+        const int mapWidth = map.getWidth();
+        const int mapHeight = map.getHeight();
+        jumpDistances.assign(map.getSize() * directions, 0);
+        // the straight directions (even) first, the diagonal ones read them
+        for(int pass = 0; pass < 2; ++pass) {
+            for(int i = pass; i < directions; i += 2) {
+                const int xFirst = dx[i] > 0 ? mapWidth - 1 : 0;
+                const int yFirst = dy[i] > 0 ? mapHeight - 1 : 0;
+                const int xStep = dx[i] > 0 ? -1 : 1;
+                const int yStep = dy[i] > 0 ? -1 : 1;
+                for(int y = yFirst; y >= 0 && y < mapHeight; y += yStep) {
+                    for(int x = xFirst; x >= 0 && x < mapWidth; x += xStep) {
+                        const int xn = x + dx[i];
+                        const int yn = y + dy[i];
+                        if(!isFree(x, y) || !isFree(xn, yn)) { continue; } // wall next to the cell: 0
+
+                        const int nextIndex = map.getIndex(xn, yn) * directions;
+                        bool jumpPoint = hasForcedNeighbour(xn, yn, i);
+                        if(i % 2 == 1) {
+                            jumpPoint = jumpPoint || jumpDistances[nextIndex + (i + 7) % 8] > 0
+                                || jumpDistances[nextIndex + (i + 1) % 8] > 0;
+                        }
+                        const int next = jumpDistances[nextIndex + i];
+                        int distance = 1;
+                        if(!jumpPoint && abs(next) < INT16_MAX - 1) { distance = next > 0 ? next + 1 : next - 1; }
+                        jumpDistances[map.getIndex(x, y) * directions + i] = distance;
+                    }
+                }
+            }
+        }
+    }
+
+    // Jump Point Search. The route returned is in the compact form, like PathFinder::findRoute
+    Route findRoute(const Position2D& Start, const Position2D& Finish) {
+        expandedNodes = 0;
+        firstHeapOperations = openNodes.getOperations();
+        if(!isFree(Start.xPos, Start.yPos) || !isFree(Finish.xPos, Finish.yPos)) { return Route(); }
+
+        // the Node maps are reset lazily, a cell is cleared the first time this search touches it
+        nodeGenerations.nextGeneration();
+
+        const int startIndex = map.getIndex(Start);
+        touchNode(startIndex);
+        levelMap[startIndex] = 0;
+        openNodes.push(NodeKey{estimate(Start.xPos, Start.yPos, Finish), startIndex});
+
+        while(!openNodes.empty()) {
+            const int n0Index = openNodes.top().index;
+            openNodes.pop();
+            const int x = n0Index % map.getWidth();
+            const int y = n0Index / map.getWidth();
+            closedNodesMap[n0Index] = 1;
+            ++expandedNodes;
+
+            if(x == Finish.xPos && y == Finish.yPos) {
+                // walk the jump points back to the start, writing every step of the segments in reverse
+                Route path;
+                for(int index = n0Index; index != startIndex; index = parentMap[index]) {
+                    const int parentIndex = parentMap[index];
+                    const int steps = std::max(abs(index % map.getWidth() - parentIndex % map.getWidth()),
+                        abs(index / map.getWidth() - parentIndex / map.getWidth()));
+                    path.append(directionsMap[index], steps);
+                }
+                path.reverse();
+                openNodes.clear(); // empty the leftover nodes
+                return path;
+            }
+            expand(x, y, levelMap[n0Index], n0Index == startIndex, Finish);
+        }
+        return Route(); // no route found
+    }
+
+    // the route as a string of direction digits
+    std::string pathFind(const Position2D& Start, const Position2D& Finish) { return findRoute(Start, Finish).toString(); }
+};
+
+#endif // _JUMPPOINTSEARCH_
@@ -0,0 +1,215 @@
+/**
+ALT (A*, Landmarks and the Triangle inequality) heuristic. http://research.microsoft.com/pubs/154937/soda05.pdf
+LandmarkTables keeps the exact distance (Dijkstra) from a few landmark cells to every cell of the map. For any landmark L the
+triangle inequality gives |d(L, finish) - d(L, n)| <= d(n, finish), so the largest of these bounds (and of the octile distance) is
+an estimate which never overestimates and stays consistent. Behind the long walls, where octile or Euclid badly underestimate, the
+landmarks behind the finish give nearly exact estimates and A* expands far fewer nodes.
+The landmarks are picked far from each other (farthest point selection). The tables can be saved to a file and loaded again for
+the same map, a checksum of the obstacles rejects the tables of an other map. The tables keep the version of the map they were
+built or loaded for: once the map changes they are stale, LandmarkHeuristic falls back to the octile distance (a stale table can
+overestimate) and save refuses to write them, until they are built again. */
+
+#ifndef _LANDMARKS_
+#define _LANDMARKS_
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include "GridMap.h"
+#include "Node.h"
+#include "OpenList.h"
+
+class LandmarkTables {
+private:
+    const GridMap& map;
+    std::vector<Position2D> landmarks;
+    std::vector<int> distances; // per cell, the distance from every landmark (count values in a row). -1: not reachable
+    unsigned int mapVersion = 0; // the version of the map the tables were built or loaded for
+
+    // Dijkstra from a landmark, written to column Landmark of distances
+    void searchDistances(const Position2D& From, const int Landmark) {
+        const int count = landmarks.size();
+        const int size = map.getSize();
+        for(int index = 0; index < size; ++index) { distances[index * count + Landmark] = -1; }
+        std::vector<unsigned char> closedNodesMap(size, 0);
+        IndexedHeapOpenList openNodes;
+        openNodes.resize(map.getWidth(), map.getHeight());
+
+        distances[map.getIndex(From) * count + Landmark] = 0;
+        openNodes.push(NodeKey{0, map.getIndex(From)});
+        while(!openNodes.empty()) {
+            const NodeKey n0 = openNodes.top();
+            openNodes.pop();
+            closedNodesMap[n0.index] = 1;
+            const int x = n0.index % map.getWidth();
+            const int y = n0.index / map.getWidth();
+            for(int i = 0; i < directions; ++i) {
+                const int xdx = x + dx[i];
+                const int ydy = y + dy[i];
+                if(!map.isInside(xdx, ydy) || map.isObstacle(xdx, ydy)) { continue; }
+                const int childIndex = map.getIndex(xdx, ydy);
+                if(closedNodesMap[childIndex] == 1) { continue; }
+                const int level = n0.priority + (directions == 8 && i % 2 == 1 ? 14 : 10);
+                int& childLevel = distances[childIndex * count + Landmark];
+                if(childLevel == -1) { openNodes.push(NodeKey{level, childIndex}); }
+                else if(level < childLevel) { openNodes.decreaseKey(NodeKey{level, childIndex}); }
+                else { continue; }
+                childLevel = level;
+            }
+        }
+    }
+
+    // FNV-1a hash of the size and the obstacles of the map
+    unsigned int getMapChecksum() const {
+        unsigned int hash = 2166136261u;
+        const int values[3] = {map.getWidth(), map.getHeight(), directions};
+        for(const int value : values) { hash = (hash ^ static_cast<unsigned int>(value)) * 16777619u; }
+        for(int y = 0; y < map.getHeight(); ++y) {
+            for(int x = 0; x < map.getWidth(); ++x) { hash = (hash ^ (map.isObstacle(x, y) ? 1u : 0u)) * 16777619u; }
+        }
+        return hash;
+    }
+public:
+    explicit LandmarkTables(const GridMap& Map) : map(Map) {}
+
+    const GridMap& getMap() const { return map; }
+    int getCount() const { return landmarks.size(); }
+    const Position2D& getLandmark(const int Landmark) const { return landmarks[Landmark]; }
+
+    // the tables were built or loaded for the current version of the map
+    bool isCurrent() const { return map.getVersion() == mapVersion; }
+
+    // the distances of a cell (flattened index) from every landmark
+    const int* getDistances(const int index) const { return &distances[index * landmarks.size()]; }
+
+    // pick Count landmarks and search their distance tables. The first one is the farthest cell from the first free cell, every
+    // other one the farthest cell from the landmarks already picked. The cells no landmark reaches are the farthest ones
+    void build(const int Count) {
+        landmarks.clear();
+        distances.clear();
+        mapVersion = map.getVersion();
+        int first = 0;
+        while(first < map.getSize() && map.isObstacle(first % map.getWidth(), first / map.getWidth())) { ++first; }
+        if(first == map.getSize() || Count <= 0) { return; }
+
+        const int size = map.getSize();
+        std::vector<int> nearest(size, -1); // distance to the nearest landmark, or to the first free cell. -1: not reached
+        {
+            landmarks.push_back(Position2D(first % map.getWidth(), first / map.getWidth()));
+            distances.assign(size, -1);
+            searchDistances(landmarks.back(), 0);
+            nearest = distances;
+            landmarks.clear();
+        }
+        std::vector<int> previous; // the tables of the landmarks already picked, one row per cell
+        while(static_cast<int>(landmarks.size()) < Count) {
+            int farthest = -1;
+            for(int index = 0; index < size; ++index) {
+                if(map.isObstacle(index % map.getWidth(), index / map.getWidth())) { continue; }
+                if(farthest == -1 || (nearest[farthest] != -1 && (nearest[index] == -1 || nearest[index] > nearest[farthest]))) {
+                    farthest = index;
+                }
+            }
+            if(nearest[farthest] == 0) { break; } // every free cell is already a landmark
+
+            // widen the rows of the tables with a column for the new landmark
+            const int count = landmarks.size();
+            previous.swap(distances);
+            distances.assign(size * (count + 1), -1);
+            for(int index = 0; index < size; ++index) {
+                std::copy(previous.begin() + index * count, previous.begin() + (index + 1) * count, distances.begin() + index * (count + 1));
+            }
+            landmarks.push_back(Position2D(farthest % map.getWidth(), farthest / map.getWidth()));
+            searchDistances(landmarks.back(), count);
+
+            for(int index = 0; index < size; ++index) {
+                const int distance = distances[index * (count + 1) + count];
+                if(distance != -1 && (nearest[index] == -1 || count == 0 || distance < nearest[index])) { nearest[index] = distance; }
+            }
+        }
+    }
+
+    // write the landmarks and the tables to a binary file. false if it can not be written, or the tables are stale
+    bool save(const std::string& FileName) const {
+        if(!isCurrent()) { return false; }
+        std::ofstream file(FileName.c_str(), std::ios::binary);
+        if(!file) { return false; }
+        const int header[4] = {map.getWidth(), map.getHeight(), directions, static_cast<int>(landmarks.size())};
+        const unsigned int checksum = getMapChecksum();
+        file.write("ALT1", 4);
+        file.write(reinterpret_cast<const char*>(header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+        for(const Position2D& landmark : landmarks) {
+            const int position[2] = {landmark.xPos, landmark.yPos};
+            file.write(reinterpret_cast<const char*>(position), sizeof(position));
+        }
+        file.write(reinterpret_cast<const char*>(distances.data()), distances.size() * sizeof(int));
+        return static_cast<bool>(file);
+    }
+
+    // read the tables written by save. false, and the tables are not changed, if the file is missing or it is for other map
+    bool load(const std::string& FileName) {
+        std::ifstream file(FileName.c_str(), std::ios::binary);
+        char magic[4];
+        int header[4];
+        unsigned int checksum;
+        if(!file.read(magic, 4) || std::memcmp(magic, "ALT1", 4) != 0) { return false; }
+        if(!file.read(reinterpret_cast<char*>(header), sizeof(header)) || !file.read(reinterpret_cast<char*>(&checksum), sizeof(checksum))) {
+            return false;
+        }
+        if(header[0] != map.getWidth() || header[1] != map.getHeight() || header[2] != directions || header[3] < 0
+            || checksum != getMapChecksum()) {
+            return false;
+        }
+
+        std::vector<Position2D> newLandmarks;
+        for(int i = 0; i < header[3]; ++i) {
+            int position[2];
+            if(!file.read(reinterpret_cast<char*>(position), sizeof(position))) { return false; }
+            newLandmarks.push_back(Position2D(position[0], position[1]));
+        }
+        std::vector<int> newDistances(map.getSize() * header[3]);
+        if(!file.read(reinterpret_cast<char*>(newDistances.data()), newDistances.size() * sizeof(int))) { return false; }
+        landmarks.swap(newLandmarks);
+        distances.swap(newDistances);
+        mapVersion = map.getVersion();
+        return true;
+    }
+};
+
+// the heuristic policy of PathFinder using the landmark tables. e.g. PathFinder<LandmarkHeuristic> finder(map, LandmarkHeuristic(t))
+class LandmarkHeuristic {
+private:
+    const LandmarkTables* tables;
+    int width = 0;
+    int xFinish = 0, yFinish = 0;
+    std::vector<int> finishDistances; // distance from every landmark to the finish. empty: the tables are stale
+public:
+    explicit LandmarkHeuristic(const LandmarkTables& Tables) : tables(&Tables), width(Tables.getMap().getWidth()) {}
+
+    // the stale tables are not read, the estimate is the octile distance
+    void setFinish(const Position2D& Finish) {
+        xFinish = Finish.xPos;
+        yFinish = Finish.yPos;
+        finishDistances.clear();
+        if(!tables->isCurrent() || tables->getCount() == 0) { return; }
+        const int* distances = tables->getDistances(Finish.yPos * width + Finish.xPos);
+        finishDistances.assign(distances, distances + tables->getCount());
+    }
+
+    int estimate(const int x, const int y) const {
+        int best = octileDistance(xFinish - x, yFinish - y);
+        if(finishDistances.empty()) { return best; }
+        const int* distances = tables->getDistances(y * width + x);
+        const int count = finishDistances.size();
+        for(int i = 0; i < count; ++i) {
+            if(distances[i] != -1 && finishDistances[i] != -1) { best = std::max(best, abs(finishDistances[i] - distances[i])); }
+        }
+        return best;
+    }
+};
+
+#endif // _LANDMARKS_
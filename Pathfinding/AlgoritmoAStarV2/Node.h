@@ -0,0 +1,111 @@
+/**
+Node: a location of the map reached by the search, with its travelled distance G(n) and its priority F(n) = G(n) + H(n).
+The movement directions are shared by all the pathfinders. The route returned is a string of direction digits (index of dx/dy). */
+
+#ifndef _NODE_
+#define _NODE_
+
+#include <math.h>
+#include <cstdlib>
+#include <algorithm>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif // _MSC_VER
+#include "GridMap.h"
+
+#define directions 8 // number of possible directions to go at any position
+#if directions==4
+static const int dx[directions]={1, 0, -1, 0};
+static const int dy[directions]={0, 1, 0, -1};
+#elif directions==8
+static const int dx[directions] = {1, 1, 0, -1, -1, -1, 0, 1};
+static const int dy[directions] = {0, 1, 1, 1, 0, -1, -1, -1};
+#endif // directions
+
+// octile distance with the 10/14 costs of nextLevel. it never overestimates and it is consistent, the searches using it are optimal
+inline int octileDistance(const int xd, const int yd) {
+    return 10 * std::max(abs(xd), abs(yd)) + 4 * std::min(abs(xd), abs(yd));
+}
+
+// the opposite of a direction. directionsMap stores the direction that goes back to the parent Node
+inline int reverseDirection(const int Direction) { return (Direction + directions / 2) % directions; }
+
+/* the free directions of a cell from the obstacles of its 3x3 neighbourhood (GridMap::getNeighbourhood): bit i for the direction i
+of dx/dy. it is a table of the 512 neighbourhoods, so a search gets all the moves of a cell with one read */
+class DirectionMasks {
+private:
+    unsigned char masks[512];
+public:
+    DirectionMasks() {
+        for(int neighbourhood = 0; neighbourhood < 512; ++neighbourhood) {
+            masks[neighbourhood] = 0;
+            for(int i = 0; i < directions; ++i) {
+                if((neighbourhood >> ((dx[i] + 1) + 3 * (dy[i] + 1)) & 1) == 0) { masks[neighbourhood] |= 1 << i; }
+            }
+        }
+    }
+    unsigned int operator[](const unsigned int Neighbourhood) const { return masks[Neighbourhood]; }
+};
+
+static const DirectionMasks directionMasks;
+
+inline unsigned int getFreeDirections(const unsigned int Neighbourhood) { return directionMasks[Neighbourhood]; }
+
+// the first direction of a mask of directions (not 0). the moves of a mask are tried with: i = lowestBit(moves); moves &= moves - 1
+inline int lowestBit(const unsigned int Mask) {
+#ifdef _MSC_VER
+    unsigned long bit;
+    _BitScanForward(&bit, Mask);
+    return static_cast<int>(bit);
+#else
+    return __builtin_ctz(Mask);
+#endif // _MSC_VER
+}
+
+class Node {
+private:
+    Position2D Location;
+    int level; // total distance already travelled to reach the Node. named G(n)
+    int priority;  // priority=level+remaining distance estimate // smaller: higher priority. named H(n)
+public:
+    Node(const Position2D& Pos, const int level, const int priority) : Location(Pos), level(level), priority(priority){}
+    Position2D getLocation() const {return Location;}
+    int getxPos() const {return Location.xPos;}
+    int getyPos() const {return Location.yPos;}
+    int getLevel() const {return level;}
+    int getPriority() const {return priority;}
+    //F(n) = G(n) + H(n)
+    void updatePriority(const Position2D& DestLocation) { priority = level + estimate(DestLocation) * 10; /*A**/ }
+
+    // give better priority to going strait instead of diagonally
+    void nextLevel(const int direction) {
+        level += (directions == 8 ? (direction % 2 == 0 ? 10 : 14) : 10);
+    }
+
+    // Estimation function for the remaining distance to the goal.
+    int estimate(const Position2D& DestLocation) const {
+        const int xd = DestLocation.xPos - Location.xPos;
+        const int yd = DestLocation.yPos - Location.yPos;
+		// Euclidian Distance. Pitagoras: h^2=a^2+b^2
+        const int distance = static_cast<int>(sqrt(xd * xd + yd * yd));
+		// Manhattan distance if x=(a,b) and y=(c,d), the Manhattan distance between x and y is |a−c|+|b−d|
+        //const int distance = abs(xd) + abs(yd);
+		// Chebyshev distance
+        //const int distance = max(abs(xd), abs(yd));
+        return distance;
+    }
+};
+
+// Determine priority (in the priority queue)
+inline bool operator<(const Node& a, const Node& b) { return a.getPriority() > b.getPriority(); }
+
+/* the entry of an open list: F(n) and the flattened index of the location. the rest of the Node (G(n) and the parent direction)
+lives in the node maps of the pathfinder, indexed by the location, so the heaps only move 8 bytes per entry */
+struct NodeKey {
+    int priority;
+    int index;
+};
+
+inline bool operator<(const NodeKey& a, const NodeKey& b) { return a.priority > b.priority; }
+
+#endif // _NODE_
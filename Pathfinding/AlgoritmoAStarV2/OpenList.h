@@ -0,0 +1,244 @@
+/**
+The open lists (list of open, not-yet-tried nodes) a PathFinder can use. They keep NodeKey entries, the priority and the flattened
+index of the location, and all of them replace an already open location by a cheaper one with decreaseKey. resize is called once
+with the map size, so the per-location data is sized at runtime. getOperations counts the push, pop and decreaseKey calls (and
+the pushes and pops done inside them) since the open list was created, for the benchmarks. */
+
+#ifndef _OPENLIST_
+#define _OPENLIST_
+
+#include <queue>
+#include <vector>
+#include <algorithm>
+#include "Node.h"
+
+// open list used by PathFinder: TwoHeapOpenList, IndexedHeapOpenList, LazyHeapOpenList or BucketOpenList
+#define openList IndexedHeapOpenList
+
+// original open list: the Node is replaced by emptying one pq to the other one. O(n log n) per decreaseKey
+class TwoHeapOpenList {
+private:
+    std::priority_queue<NodeKey> pq[2];
+    int pqi = 0; // pq index
+    long long operations = 0;
+public:
+    void resize(const int /*Width*/, const int /*Height*/) {}
+    long long getOperations() const { return operations; }
+    bool empty() const { return pq[pqi].empty(); }
+    size_t size() const { return pq[pqi].size(); }
+    const NodeKey& top() const { return pq[pqi].top(); }
+    void push(const NodeKey& Value) { ++operations; pq[pqi].push(Value); }
+    void pop() { ++operations; pq[pqi].pop(); }
+    void clear() { while(!pq[pqi].empty()) { pq[pqi].pop(); } }
+
+    void decreaseKey(const NodeKey& Value) {
+        /* replace the Node by emptying one pq to the other one except the Node to be replaced will be ignored and the
+		new Node will be pushed in instead */
+        const NodeKey& replaceNode = pq[pqi].top();
+        while(replaceNode.index != Value.index) {
+            pq[1 - pqi].push(replaceNode);
+            pq[pqi].pop();
+            operations += 2;
+        }
+        pq[pqi].pop(); // remove the wanted Node
+
+        // empty the larger size pq to the smaller one
+        if(pq[pqi].size() > pq[1 - pqi].size()) { pqi = 1 - pqi; }
+        while(!pq[pqi].empty()) {
+            pq[1 - pqi].push(pq[pqi].top());
+            pq[pqi].pop();
+            operations += 2;
+        }
+        pqi = 1 - pqi;
+        pq[pqi].push(Value); // add the better Node instead
+        operations += 2;
+    }
+};
+
+// indexed 4-ary heap. heapIndexMap keeps the heap slot of every open location, so decreaseKey only sifts the Node up. O(log n)
+class IndexedHeapOpenList {
+private:
+    std::vector<NodeKey> heap;
+    std::vector<int> heapIndexMap; // map of heap slots (position-to-handle index)
+    long long operations = 0;
+
+    void place(const NodeKey& Value, const int slot) {
+        heap[slot] = Value;
+        heapIndexMap[Value.index] = slot;
+    }
+
+    void siftUp(int slot) {
+        const NodeKey value = heap[slot];
+        while(slot > 0) {
+            const int parent = (slot - 1) / 4;
+            if(heap[parent].priority <= value.priority) { break; }
+            place(heap[parent], slot);
+            slot = parent;
+        }
+        place(value, slot);
+    }
+
+    void siftDown(int slot) {
+        const NodeKey value = heap[slot];
+        const int size = heap.size();
+        while(true) {
+            const int firstChild = slot * 4 + 1;
+            if(firstChild >= size) { break; }
+            const int lastChild = std::min(firstChild + 4, size);
+            int best = firstChild;
+            for(int child = firstChild + 1; child < lastChild; ++child) {
+                if(heap[child].priority < heap[best].priority) { best = child; }
+            }
+            if(heap[best].priority >= value.priority) { break; }
+            place(heap[best], slot);
+            slot = best;
+        }
+        place(value, slot);
+    }
+public:
+    void resize(const int Width, const int Height) { heapIndexMap.assign(Width * Height, 0); }
+    long long getOperations() const { return operations; }
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+    const NodeKey& top() const { return heap.front(); }
+    void push(const NodeKey& Value) { ++operations; heap.push_back(Value); siftUp(heap.size() - 1); }
+    void clear() { heap.clear(); }
+
+    void pop() {
+        ++operations;
+        heap.front() = heap.back();
+        heap.pop_back();
+        if(!heap.empty()) { siftDown(0); }
+    }
+
+    void decreaseKey(const NodeKey& Value) {
+        ++operations;
+        const int slot = heapIndexMap[Value.index];
+        heap[slot] = Value;
+        siftUp(slot);
+    }
+};
+
+/* lazy deletion: decreaseKey pushes a duplicate Node and the old one stays in the pq. bestPriorityMap keeps the priority of the
+live Node of every location, the other ones are stale and they are skipped when they reach the top */
+class LazyHeapOpenList {
+private:
+    std::priority_queue<NodeKey> pq;
+    std::vector<int> bestPriorityMap; // map of the priority of the live Node. -1 once it has been popped
+    long long operations = 0;
+
+    void skipStaleNodes() {
+        while(!pq.empty() && bestPriorityMap[pq.top().index] != pq.top().priority) { ++operations; pq.pop(); }
+    }
+public:
+    void resize(const int Width, const int Height) { bestPriorityMap.assign(Width * Height, -1); }
+    long long getOperations() const { return operations; }
+    bool empty() { skipStaleNodes(); return pq.empty(); }
+    size_t size() const { return pq.size(); } // stale nodes included
+    const NodeKey& top() { skipStaleNodes(); return pq.top(); }
+    void push(const NodeKey& Value) { ++operations; bestPriorityMap[Value.index] = Value.priority; pq.push(Value); }
+    void pop() { ++operations; bestPriorityMap[pq.top().index] = -1; pq.pop(); }
+    void clear() { while(!pq.empty()) { pq.pop(); } }
+    void decreaseKey(const NodeKey& Value) { push(Value); }
+};
+
+/* bucket queue: the priorities are small integers (sums of 10, 14 and the heuristic), and with a consistent heuristic the priorities
+of the open nodes are between the lowest one and the lowest one plus twice the cost of a step. So the nodes are kept in a ring of
+buckets, one per priority, and push, pop and decreaseKey are O(1): a bucket is a doubly linked list of locations (nextMap and
+previousMap), no comparison is done. The lowest bucket is found by moving a cursor forward. A priority lower than the cursor
+(inconsistent heuristics) moves it back, and the ring doubles its size when the priorities do not fit in it.
+Use it with a consistent integer estimate (OctileHeuristic, ManhattanHeuristic). With an inconsistent one (the truncated
+EuclideanHeuristic of defaultHeuristic) a node can be closed before its best G(n), and the LIFO order of the buckets makes it happen
+often, so the routes are not always the shortest. */
+class BucketOpenList {
+private:
+    std::vector<int> bucketHeads; // first location of every bucket (priority & mask). -1: empty
+    std::vector<int> nextMap, previousMap; // links of the locations in their bucket. -1: end
+    std::vector<int> priorityMap; // priority of every open location
+    int mask = 63; // buckets - 1, the number of buckets is a power of two
+    int cursor = 0; // no open location has a lower priority
+    int highest = 0; // no open location has a higher priority
+    size_t count = 0;
+    NodeKey topNode{0, 0};
+    long long operations = 0;
+
+    void link(const NodeKey& Value) {
+        int& head = bucketHeads[Value.priority & mask];
+        priorityMap[Value.index] = Value.priority;
+        previousMap[Value.index] = -1;
+        nextMap[Value.index] = head;
+        if(head != -1) { previousMap[head] = Value.index; }
+        head = Value.index;
+    }
+
+    void unlink(const int index) {
+        const int next = nextMap[index], previous = previousMap[index];
+        if(previous == -1) { bucketHeads[priorityMap[index] & mask] = next; }
+        else { nextMap[previous] = next; }
+        if(next != -1) { previousMap[next] = previous; }
+    }
+
+    // make room for a priority: more buckets when the open priorities do not fit in the ring
+    void reserve(const int Priority) {
+        if(count == 0) { cursor = highest = Priority; return; }
+        const int lowest = std::min(cursor, Priority);
+        highest = std::max(highest, Priority);
+        cursor = lowest;
+        if(highest - lowest <= mask) { return; }
+
+        std::vector<int> locations;
+        for(int bucket = 0; bucket <= mask; ++bucket) {
+            for(int index = bucketHeads[bucket]; index != -1; index = nextMap[index]) { locations.push_back(index); }
+        }
+        int buckets = mask + 1;
+        while(buckets <= highest - lowest) { buckets *= 2; }
+        mask = buckets - 1;
+        bucketHeads.assign(buckets, -1);
+        for(const int index : locations) { link(NodeKey{priorityMap[index], index}); }
+    }
+public:
+    void resize(const int Width, const int Height) {
+        nextMap.assign(Width * Height, -1);
+        previousMap.assign(Width * Height, -1);
+        priorityMap.assign(Width * Height, 0);
+        bucketHeads.assign(mask + 1, -1);
+    }
+    long long getOperations() const { return operations; }
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+
+    const NodeKey& top() {
+        while(bucketHeads[cursor & mask] == -1) { ++cursor; }
+        topNode = NodeKey{cursor, bucketHeads[cursor & mask]};
+        return topNode;
+    }
+
+    void push(const NodeKey& Value) {
+        ++operations;
+        reserve(Value.priority);
+        link(Value);
+        ++count;
+    }
+
+    void pop() {
+        ++operations;
+        unlink(top().index);
+        --count;
+    }
+
+    void clear() {
+        std::fill(bucketHeads.begin(), bucketHeads.end(), -1);
+        count = 0;
+    }
+
+    void decreaseKey(const NodeKey& Value) {
+        ++operations;
+        unlink(Value.index);
+        --count;
+        reserve(Value.priority);
+        link(Value);
+        ++count;
+    }
+};
+
+#endif // _OPENLIST_
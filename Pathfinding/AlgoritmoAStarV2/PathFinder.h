@@ -0,0 +1,205 @@
+/**
+PathFinder: the A* search over a GridMap. Every PathFinder owns its node maps and its open list, all of them flattened and sized
+from the map at runtime, and there is no static state, so several PathFinder objects can search the same map at the same time.
+The node maps are the node storage: G(n), F(n) and the parent direction of a Node live at the index of its location, and the open
+list only keeps NodeKey entries, so no Node is allocated or copied around while searching.
+The heuristic, the connectivity and the terrain are compile-time policies (Heuristics.h), e.g. PathFinder<OctileHeuristic,
+FourConnected>. PathFinder<OctileHeuristic, EightConnected, openList, WeightedTerrain> uses the traversal costs of the cells.
+With the connected components of the map (setComponents) a finish out of the component of the start is rejected without searching.
+The moves of a Node are the free directions of its neighbourhood in the bit grid of the map, so there are no bounds or obstacle
+checks per move, and the closed flags are bits too.
+A search can also be spread over many calls, e.g. over the frames of a game: startSearch begins it, and step (a number of
+expansions) or runFor (a deadline) continue it until its status is found or failed. The open list and the node maps keep the
+progress between the calls, so a PathFinder holds one pending search at a time. */
+
+#ifndef _PATHFINDER_
+#define _PATHFINDER_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <chrono>
+#include <limits>
+#include <algorithm>
+#include "GridMap.h"
+#include "Node.h"
+#include "Route.h"
+#include "OpenList.h"
+#include "GenerationMap.h"
+#include "Heuristics.h"
+#include "ConnectedComponents.h"
+
+enum class SearchStatus { pending, found, failed };
+
+template<class Heuristic = defaultHeuristic, class Connectivity = defaultConnectivity, class OpenList = openList,
+    class Terrain = UniformTerrain>
+class PathFinder {
+private:
+    static const int checkInterval = 64; // expansions between two checks of the deadline of runFor
+
+    const GridMap& map;
+    std::vector<uint64_t> closedNodesMap; // map of closed (tried-out) nodes, a bit per cell
+    std::vector<int> openNodesMap; // map of open (not-yet-tried) nodes
+    std::vector<int> levelMap; // map of G(n) of the reached nodes
+    std::vector<unsigned char> directionsMap; // map of directions
+    GenerationMap nodeGenerations; // cells of the node maps written by the current search
+    OpenList openNodes; // list of open (not-yet-tried) nodes
+    Heuristic heuristic; // estimate of the remaining distance to the finish
+    ConnectedComponents<Connectivity>* components = nullptr; // to reject the unreachable finishes. optional
+    long long expandedNodes = 0; // nodes expanded by the last search
+    long long firstHeapOperations = 0; // operations of the open list before the last search
+    Position2D start, finish; // of the last search
+    SearchStatus status = SearchStatus::failed; // of the last search
+    Route route; // found by the last search
+
+    // clear the Node maps of a cell the first time the current search touches it
+    void touchNode(const int index) {
+        if(nodeGenerations.touch(index)) {
+            closedNodesMap[index >> 6] &= ~(uint64_t(1) << (index & 63));
+            openNodesMap[index] = 0;
+        }
+    }
+
+    bool isClosed(const int index) const { return (closedNodesMap[index >> 6] >> (index & 63) & 1) != 0; }
+public:
+    // the heuristics with data of their own (e.g. LandmarkHeuristic) are given to the constructor
+    explicit PathFinder(const GridMap& Map, const Heuristic& Estimate = Heuristic())
+        : map(Map), closedNodesMap((Map.getSize() + 63) / 64), openNodesMap(Map.getSize()), levelMap(Map.getSize()),
+        directionsMap(Map.getSize()), heuristic(Estimate), start(0, 0), finish(0, 0) {
+        openNodes.resize(Map.getWidth(), Map.getHeight());
+        nodeGenerations.resize(Map.getSize());
+    }
+
+    const GridMap& getMap() const { return map; }
+    long long getExpandedNodes() const { return expandedNodes; }
+    long long getHeapOperations() const { return openNodes.getOperations() - firstHeapOperations; }
+    void setComponents(ConnectedComponents<Connectivity>* Components) { components = Components; }
+    // the bytes of the node maps, as big as the map. the open list is not counted
+    size_t getMemoryBytes() const {
+        return closedNodesMap.size() * sizeof(uint64_t) + (openNodesMap.size() + levelMap.size()) * sizeof(int)
+            + directionsMap.size() + map.getSize() * sizeof(unsigned int); // the last ones are the generation stamps
+    }
+
+    const Position2D& getStart() const { return start; }
+    const Position2D& getFinish() const { return finish; }
+    SearchStatus getStatus() const { return status; }
+    const Route& getRoute() const { return route; } // the route of a found search
+
+    // begin a search, it is pending until step or runFor find the route or fail. the map must not change while it is pending
+    void startSearch(const Position2D& Start, const Position2D& Finish) {
+        start = Start;
+        finish = Finish;
+        route = Route();
+        openNodes.clear(); // the leftover nodes of a search which was not finished
+        expandedNodes = 0;
+        firstHeapOperations = openNodes.getOperations();
+        status = SearchStatus::pending;
+        if(components != nullptr && !components->isConnected(Start, Finish)) { // no route, in O(1)
+            status = SearchStatus::failed;
+            return;
+        }
+
+        // the Node maps are reset lazily, a cell is cleared the first time this search touches it
+        nodeGenerations.nextGeneration();
+
+        // create the start Node and push into list of open nodes
+        const int startIndex = map.getIndex(Start);
+        heuristic.setFinish(Finish);
+        const int startPriority = Terrain::scaleEstimate(map, heuristic.estimate(Start.xPos, Start.yPos));
+        touchNode(startIndex);
+        levelMap[startIndex] = 0;
+        openNodesMap[startIndex] = startPriority; // mark it on the open nodes map
+        openNodes.push(NodeKey{startPriority, startIndex});
+    }
+
+    // continue the pending search for at most MaxExpansions nodes
+    SearchStatus step(const long long MaxExpansions) {
+        const int mapWidth = map.getWidth();
+        const long long lastExpansion = expandedNodes + MaxExpansions;
+
+        // A* search
+        while(status == SearchStatus::pending && expandedNodes < lastExpansion) {
+            if(openNodes.empty()) {
+                status = SearchStatus::failed; // no route found
+                break;
+            }
+
+            // get the current Node w/ the highest priority from the list of open nodes
+            const int n0Index = openNodes.top().index;
+            int x = n0Index % mapWidth;
+            int y = n0Index / mapWidth;
+            const int n0Level = levelMap[n0Index];
+
+            openNodes.pop(); // remove the Node from the open list
+            openNodesMap[n0Index] = 0;
+            closedNodesMap[n0Index >> 6] |= uint64_t(1) << (n0Index & 63); // mark it on the closed nodes map
+            ++expandedNodes;
+
+            // quit searching when the goal state is reached
+            if(x == finish.xPos && y == finish.yPos) {
+                // generate the path from finish to start by following the directions, and reverse it
+                while(!(x == start.xPos && y == start.yPos)) {
+                    const int j = directionsMap[map.getIndex(x, y)];
+                    route.append(reverseDirection(j));
+                    x += dx[j];
+                    y += dy[j];
+                }
+                route.reverse();
+
+                openNodes.clear(); // empty the leftover nodes
+                status = SearchStatus::found;
+                break;
+            }
+
+            // generate moves (child nodes) in all the free directions
+            for(unsigned int moves = getFreeDirections(map.getNeighbourhood(x, y)) & Connectivity::mask; moves != 0;
+                moves &= moves - 1) {
+                const int i = lowestBit(moves);
+                const int xdx = x + dx[i];
+                const int ydy = y + dy[i];
+                const int childIndex = map.getIndex(xdx, ydy);
+                touchNode(childIndex);
+                if(isClosed(childIndex)) { continue; }
+
+                // generate a child Node. F(n) = G(n) + H(n)
+                const int m0Level = n0Level + Terrain::stepCost(map, childIndex, Connectivity::stepCost(i));
+                const int m0Priority = m0Level + Terrain::scaleEstimate(map, heuristic.estimate(xdx, ydy));
+
+                // if it is not in the open list then add into that
+                int& openNode = openNodesMap[childIndex];
+                unsigned char& direction = directionsMap[childIndex];
+                if(openNode == 0) {
+                    openNode = m0Priority;
+                    levelMap[childIndex] = m0Level;
+                    openNodes.push(NodeKey{m0Priority, childIndex});
+                    direction = reverseDirection(i); // mark its parent Node direction
+                }
+                else if(openNode > m0Priority) {
+                    openNode = m0Priority; // update the priority info
+                    levelMap[childIndex] = m0Level;
+                    direction = reverseDirection(i); // update the parent direction info
+                    openNodes.decreaseKey(NodeKey{m0Priority, childIndex}); // replace the open Node by the better one
+                }
+            }
+        }
+        return status;
+    }
+
+    // continue the pending search until it ends or until the deadline. the deadline is checked every few expansions
+    SearchStatus runFor(const std::chrono::steady_clock::time_point& Deadline) {
+        while(step(checkInterval) == SearchStatus::pending && std::chrono::steady_clock::now() < Deadline) {}
+        return status;
+    }
+
+    // A-star algorithm, the whole search at once. The route returned is in the compact (run-length) form
+    Route findRoute(const Position2D& Start, const Position2D& Finish) {
+        startSearch(Start, Finish);
+        step(std::numeric_limits<long long>::max());
+        return route;
+    }
+
+    // the route as a string of direction digits
+    std::string pathFind(const Position2D& Start, const Position2D& Finish) { return findRoute(Start, Finish).toString(); }
+};
+
+#endif // _PATHFINDER_
@@ -0,0 +1,84 @@
+/**
+Route: the compact form of a route. It is a list of runs, each one with a direction (index of dx/dy) and the number of steps in that
+direction, so a long straight corridor is a single run. A pathfinder appends the steps while it follows the parents from the finish
+and reverses the runs once at the end, so building a route is linear in its length. toString is the old digit string view. */
+
+#ifndef _ROUTE_
+#define _ROUTE_
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "Node.h"
+#include "GridMap.h"
+
+struct RouteRun {
+    unsigned char direction;
+    int count; // number of steps
+};
+
+class Route {
+private:
+    std::vector<RouteRun> runs;
+    int steps = 0; // sum of the counts
+public:
+    Route() {}
+
+    // a route from its digit string view
+    explicit Route(const std::string& Digits) {
+        for(const char c : Digits) { append(c - '0'); }
+    }
+
+    bool empty() const { return steps == 0; }
+    int size() const { return steps; }
+    const std::vector<RouteRun>& getRuns() const { return runs; }
+    void clear() { runs.clear(); steps = 0; }
+
+    // add steps in a direction at the end of the route, extending the last run when it has the same direction
+    void append(const int Direction, const int Count = 1) {
+        if(!runs.empty() && runs.back().direction == Direction) { runs.back().count += Count; }
+        else { runs.push_back(RouteRun{static_cast<unsigned char>(Direction), Count}); }
+        steps += Count;
+    }
+
+    // add a whole route at the end, e.g. the refined segments of HPA*
+    void append(const Route& Other) {
+        for(const RouteRun& run : Other.runs) { append(run.direction, run.count); }
+    }
+
+    // reverse the order of the runs. the directions are kept, a route built from the finish is appended with the forward ones
+    void reverse() { std::reverse(runs.begin(), runs.end()); }
+
+    // cost of the route with the 10/14 costs of Node::nextLevel
+    int getCost() const {
+        int cost = 0;
+        for(const RouteRun& run : runs) { cost += run.count * (directions == 8 && run.direction % 2 == 1 ? 14 : 10); }
+        return cost;
+    }
+
+    // cost of the route with the traversal costs of the cells it enters (GridMap::setCost)
+    int getCost(const GridMap& Map, const Position2D& Start) const {
+        int cost = 0;
+        int x = Start.xPos;
+        int y = Start.yPos;
+        for(const RouteRun& run : runs) {
+            const int stepCost = directions == 8 && run.direction % 2 == 1 ? 14 : 10;
+            for(int i = 0; i < run.count; ++i) {
+                x += dx[run.direction];
+                y += dy[run.direction];
+                cost += stepCost * Map.getCost(x, y);
+            }
+        }
+        return cost;
+    }
+
+    // the route as a string of direction digits
+    std::string toString() const {
+        std::string digits;
+        digits.reserve(steps);
+        for(const RouteRun& run : runs) { digits.append(run.count, '0' + run.direction); }
+        return digits;
+    }
+};
+
+#endif // _ROUTE_
@@ -0,0 +1,69 @@
+/**
+Loader of the Moving AI benchmark files. https://movingai.com/benchmarks/formats.html
+A .map file has a "type octile" header with the height and the width, and one text row per line of the map: '.', 'G' and 'S' are
+passable, any other tile ('@', 'O', 'T', 'W') is an obstacle. A .scen file has a "version 1" line and one scenario per line:
+bucket, map file, map width, map height, start x, start y, goal x, goal y and the optimal length.
+The optimal lengths of the files cost sqrt(2) per diagonal move and do not allow cutting corners. The pathfinders of this project
+cost 1.4 (14 / 10) per diagonal move and cut corners, so their routes can be a bit shorter than the ones of the files. */
+
+#ifndef _SCENARIOLOADER_
+#define _SCENARIOLOADER_
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include "GridMap.h"
+
+struct Scenario {
+    int bucket;
+    std::string mapName; // map file, relative to the .scen file
+    Position2D Start, Finish;
+    double optimalLength; // with the Moving AI costs
+
+    Scenario(const int Bucket, const std::string& MapName, const Position2D& Start, const Position2D& Finish, const double Length)
+        : bucket(Bucket), mapName(MapName), Start(Start), Finish(Finish), optimalLength(Length) {}
+};
+
+// the map of a .map file. An empty map (getSize() == 0) if the file can not be read
+inline GridMap loadMovingAIMap(const std::string& FileName) {
+    std::ifstream file(FileName.c_str());
+    std::string word;
+    int width = 0, height = 0;
+    while(file >> word && word != "map") {
+        if(word == "height") { file >> height; }
+        else if(word == "width") { file >> width; }
+    }
+    if(!file || width <= 0 || height <= 0) { return GridMap(0, 0); }
+
+    GridMap map(width, height);
+    std::string row;
+    std::getline(file, row); // end of the "map" line
+    for(int y = 0; y < height; ++y) {
+        if(!std::getline(file, row) || static_cast<int>(row.size()) < width) { return GridMap(0, 0); }
+        for(int x = 0; x < width; ++x) {
+            const char tile = row[x];
+            map.setObstacle(x, y, !(tile == '.' || tile == 'G' || tile == 'S'));
+        }
+    }
+    return map;
+}
+
+// the scenarios of a .scen file. Empty if the file can not be read
+inline std::vector<Scenario> loadMovingAIScenarios(const std::string& FileName) {
+    std::vector<Scenario> scenarios;
+    std::ifstream file(FileName.c_str());
+    std::string line;
+    while(std::getline(file, line)) {
+        std::istringstream fields(line);
+        int bucket, mapWidth, mapHeight, xStart, yStart, xFinish, yFinish;
+        std::string mapName;
+        double length;
+        if(fields >> bucket >> mapName >> mapWidth >> mapHeight >> xStart >> yStart >> xFinish >> yFinish >> length) {
+            scenarios.push_back(Scenario(bucket, mapName, Position2D(xStart, yStart), Position2D(xFinish, yFinish), length));
+        }
+    }
+    return scenarios; // the "version" line does not parse as a scenario
+}
+
+#endif // _SCENARIOLOADER_
@@ -0,0 +1,112 @@
+/**
+VoxelMap: the 3D obstacle grid of the flying units, searched by VoxelPathFinder. The size is given at runtime.
+The voxels are kept in chunks of 16x16x16, and a chunk is 64 words of 64 bits, one bit per voxel (1: obstacle). A chunk is only
+allocated when one of its voxels becomes an obstacle, so the empty space (most of a volume of flying units) takes no memory but
+the pointer of its chunk: a 512x512x512 volume is 32768 chunks, 256 KB of pointers, and 512 bytes per chunk with obstacles, 16 MB
+when all of them have some.
+A voxel is named by its key: the index of its chunk times 4096 plus its index in the chunk. The node maps of VoxelPathFinder are
+chunked the same way, so a search only allocates the chunks it visits too. The voxels out of the map are obstacles. */
+
+#ifndef _VOXELMAP_
+#define _VOXELMAP_
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <algorithm>
+
+struct Position3D {
+public:
+    int xPos, yPos, zPos;
+    Position3D(const int xPos, const int yPos, const int zPos) : xPos(xPos), yPos(yPos), zPos(zPos) {}
+    bool operator==(const Position3D& Other) const { return xPos == Other.xPos && yPos == Other.yPos && zPos == Other.zPos; }
+};
+
+class VoxelMap {
+public:
+    static const int chunkShift = 4; // the chunks are 16 voxels wide
+    static const int chunkSize = 1 << chunkShift;
+    static const int chunkVoxels = chunkSize * chunkSize * chunkSize;
+    static const int chunkWords = chunkVoxels / 64;
+private:
+    int width, height, depth;
+    int chunksWide, chunksHigh, chunksDeep;
+    std::vector<std::unique_ptr<uint64_t[]> > chunks; // (cz * chunksHigh + cy) * chunksWide + cx. null: no obstacles
+    int allocatedChunks = 0;
+    unsigned int version = 0; // incremented by every change of the voxels
+
+    int getChunk(const int x, const int y, const int z) const {
+        return ((z >> chunkShift) * chunksHigh + (y >> chunkShift)) * chunksWide + (x >> chunkShift);
+    }
+
+    static int getLocal(const int x, const int y, const int z) {
+        const int mask = chunkSize - 1;
+        return ((z & mask) << (2 * chunkShift)) | ((y & mask) << chunkShift) | (x & mask);
+    }
+public:
+    VoxelMap(const int width, const int height, const int depth) : width(width), height(height), depth(depth),
+        chunksWide((width + chunkSize - 1) >> chunkShift), chunksHigh((height + chunkSize - 1) >> chunkShift),
+        chunksDeep((depth + chunkSize - 1) >> chunkShift) {
+        chunks.resize(static_cast<size_t>(chunksWide) * chunksHigh * chunksDeep);
+    }
+
+    VoxelMap(const VoxelMap&) = delete;
+    VoxelMap& operator=(const VoxelMap&) = delete;
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getDepth() const { return depth; }
+    unsigned int getVersion() const { return version; }
+    int getChunksCount() const { return chunks.size(); }
+    // the bytes of the occupancy: the pointers of the chunks and the bits of the allocated ones
+    size_t getMemoryBytes() const { return chunks.size() * sizeof(chunks[0]) + allocatedChunks * chunkWords * sizeof(uint64_t); }
+
+    bool isInside(const int x, const int y, const int z) const {
+        return x >= 0 && x < width && y >= 0 && y < height && z >= 0 && z < depth;
+    }
+
+    // the key of a voxel: the index of its chunk * chunkVoxels + its index in the chunk
+    int getKey(const int x, const int y, const int z) const { return getChunk(x, y, z) * chunkVoxels + getLocal(x, y, z); }
+    int getKey(const Position3D& Location) const { return getKey(Location.xPos, Location.yPos, Location.zPos); }
+
+    Position3D getPosition(const int Key) const {
+        const int chunk = Key / chunkVoxels, local = Key % chunkVoxels;
+        const int mask = chunkSize - 1;
+        return Position3D((chunk % chunksWide) * chunkSize + (local & mask),
+            (chunk / chunksWide % chunksHigh) * chunkSize + ((local >> chunkShift) & mask),
+            (chunk / chunksWide / chunksHigh) * chunkSize + (local >> (2 * chunkShift)));
+    }
+
+    // the voxels out of the map are obstacles too
+    bool isObstacle(const int x, const int y, const int z) const {
+        if(!isInside(x, y, z)) { return true; }
+        const uint64_t* chunk = chunks[getChunk(x, y, z)].get();
+        if(chunk == nullptr) { return false; }
+        const int local = getLocal(x, y, z);
+        return (chunk[local >> 6] >> (local & 63) & 1) != 0;
+    }
+
+    void setObstacle(const int x, const int y, const int z, const bool Value) {
+        std::unique_ptr<uint64_t[]>& chunk = chunks[getChunk(x, y, z)];
+        if(chunk == nullptr) {
+            if(!Value) { return; }
+            chunk.reset(new uint64_t[chunkWords]());
+            ++allocatedChunks;
+        }
+        const int local = getLocal(x, y, z);
+        if(Value) { chunk[local >> 6] |= uint64_t(1) << (local & 63); }
+        else { chunk[local >> 6] &= ~(uint64_t(1) << (local & 63)); }
+        ++version;
+    }
+
+    // set all the voxels of a box, from (x0, y0, z0) to (x1, y1, z1) included, e.g. a building
+    void setBox(const int x0, const int y0, const int z0, const int x1, const int y1, const int z1, const bool Value) {
+        for(int z = std::max(z0, 0); z <= std::min(z1, depth - 1); ++z) {
+            for(int y = std::max(y0, 0); y <= std::min(y1, height - 1); ++y) {
+                for(int x = std::max(x0, 0); x <= std::min(x1, width - 1); ++x) { setObstacle(x, y, z, Value); }
+            }
+        }
+    }
+};
+
+#endif // _VOXELMAP_
@@ -0,0 +1,194 @@
+/**
+VoxelPathFinder: the A* search over a VoxelMap, for the flying units.
+The moves are the 26 neighbours of a voxel: the 6 faces (cost 10), the 12 edges (cost 14) and the 8 corners (cost 17, 10 * sqrt(3)),
+in this order in the dx3/dy3/dz3 tables, so the connectivity policies SixConnected, EighteenConnected and TwentySixConnected only
+try the first 6, 18 or 26 of them. Like the diagonal moves of the 2D searches, a move only needs the destination voxel to be free.
+The estimate of every connectivity is the exact distance on an empty volume with its moves (the 3D octile distance for 26), so it
+is consistent and the routes are optimal.
+The node maps (G(n), the direction of the parent and the closed flags) are chunked like the VoxelMap: a chunk is allocated the first
+time a search reaches it and it is reset by generation, so the memory follows the chunks the searches visit and not the volume. The
+open list is a binary heap whose old entries are skipped when popped, it only holds the frontier. The route returned is the list of
+voxels from the start to the finish. */
+
+#ifndef _VOXELPATHFINDER_
+#define _VOXELPATHFINDER_
+
+#include <vector>
+#include <queue>
+#include <memory>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include "VoxelMap.h"
+#include "Node.h"
+
+// the faces, the edges and the corners of a voxel
+static const int dx3[26] = {1, -1, 0, 0, 0, 0, 1, 1, -1, -1, 1, 1, -1, -1, 0, 0, 0, 0, 1, 1, 1, 1, -1, -1, -1, -1};
+static const int dy3[26] = {0, 0, 1, -1, 0, 0, 1, -1, 1, -1, 0, 0, 0, 0, 1, 1, -1, -1, 1, 1, -1, -1, 1, 1, -1, -1};
+static const int dz3[26] = {0, 0, 0, 0, 1, -1, 0, 0, 0, 0, 1, -1, 1, -1, 1, -1, 1, -1, 1, -1, 1, -1, 1, -1, 1, -1};
+
+// the cost of a move: 10 for a face, 14 for an edge, 17 for a corner
+inline int voxelStepCost(const int Direction) { return Direction < 6 ? 10 : (Direction < 18 ? 14 : 17); }
+
+// the distances sorted from the largest to the smallest
+inline void sortDistances(const int xd, const int yd, const int zd, int& a, int& b, int& c) {
+    a = abs(xd);
+    b = abs(yd);
+    c = abs(zd);
+    if(a < b) { std::swap(a, b); }
+    if(b < c) { std::swap(b, c); }
+    if(a < b) { std::swap(a, b); }
+}
+
+// only the faces
+struct SixConnected {
+    static const int count = 6;
+    static int estimate(const int xd, const int yd, const int zd) { return 10 * (abs(xd) + abs(yd) + abs(zd)); }
+};
+
+// the faces and the edges. an edge move covers two axes, so every two units of distance cost 14 while they can be paired
+struct EighteenConnected {
+    static const int count = 18;
+    static int estimate(const int xd, const int yd, const int zd) {
+        int a, b, c;
+        sortDistances(xd, yd, zd, a, b, c);
+        if(a >= b + c) { return 14 * (b + c) + 10 * (a - b - c); }
+        const int total = a + b + c;
+        return 14 * (total / 2) + 10 * (total % 2);
+    }
+};
+
+// the faces, the edges and the corners. the 3D octile distance
+struct TwentySixConnected {
+    static const int count = 26;
+    static int estimate(const int xd, const int yd, const int zd) {
+        int a, b, c;
+        sortDistances(xd, yd, zd, a, b, c);
+        return 17 * c + 14 * (b - c) + 10 * (a - b);
+    }
+};
+
+template<class Connectivity = TwentySixConnected>
+class VoxelPathFinder {
+private:
+    // the node maps of a chunk of the VoxelMap
+    struct NodeChunk {
+        unsigned int generation = 0; // the search which reset the chunk last
+        int levels[VoxelMap::chunkVoxels]; // G(n). -1: not reached
+        unsigned char moves[VoxelMap::chunkVoxels]; // the move (index of dx3/dy3/dz3) which reached the voxel
+        uint64_t closed[VoxelMap::chunkWords]; // the closed (tried-out) voxels
+    };
+
+    const VoxelMap& map;
+    std::vector<std::unique_ptr<NodeChunk> > nodeChunks; // by the index of the chunk. null: never reached
+    int allocatedChunks = 0;
+    unsigned int generation = 0; // of the current search
+    long long expandedNodes = 0; // nodes expanded by the last pathFind call
+    long long heapOperations = 0;
+    int routeCost = 0; // cost of the last route
+
+    // the node maps of the chunk of a key, allocated or reset the first time the current search reaches it
+    NodeChunk& getNodeChunk(const int Key) {
+        std::unique_ptr<NodeChunk>& chunk = nodeChunks[Key / VoxelMap::chunkVoxels];
+        if(chunk == nullptr) {
+            chunk.reset(new NodeChunk());
+            ++allocatedChunks;
+        }
+        if(chunk->generation != generation) {
+            chunk->generation = generation;
+            std::fill(chunk->levels, chunk->levels + VoxelMap::chunkVoxels, -1);
+            std::fill(chunk->closed, chunk->closed + VoxelMap::chunkWords, 0);
+        }
+        return *chunk;
+    }
+public:
+    explicit VoxelPathFinder(const VoxelMap& Map) : map(Map), nodeChunks(Map.getChunksCount()) {}
+
+    const VoxelMap& getMap() const { return map; }
+    long long getExpandedNodes() const { return expandedNodes; }
+    long long getHeapOperations() const { return heapOperations; }
+    int getCost() const { return routeCost; } // the cost of the last route
+    // the bytes of the node chunks, allocated by all the searches until now
+    size_t getMemoryBytes() const { return nodeChunks.size() * sizeof(nodeChunks[0]) + allocatedChunks * sizeof(NodeChunk); }
+
+    // free the node chunks, e.g. after a search over a big part of the volume
+    void releaseNodes() {
+        for(std::unique_ptr<NodeChunk>& chunk : nodeChunks) { chunk.reset(); }
+        allocatedChunks = 0;
+    }
+
+    // A-star algorithm in 3D. The route returned is the list of voxels from the start to the finish, empty if not found
+    std::vector<Position3D> findRoute(const Position3D& Start, const Position3D& Finish) {
+        expandedNodes = 0;
+        heapOperations = 0;
+        routeCost = 0;
+        if(++generation == 0) { // the stamps wrap around, all the chunks are reset
+            for(std::unique_ptr<NodeChunk>& chunk : nodeChunks) { if(chunk != nullptr) { chunk->generation = 0; } }
+            generation = 1;
+        }
+        if(map.isObstacle(Start.xPos, Start.yPos, Start.zPos) || map.isObstacle(Finish.xPos, Finish.yPos, Finish.zPos)) {
+            return std::vector<Position3D>();
+        }
+
+        std::priority_queue<NodeKey> openNodes; // list of open (not-yet-tried) nodes. the old entries are skipped
+        const int startKey = map.getKey(Start);
+        const int finishKey = map.getKey(Finish);
+        getNodeChunk(startKey).levels[startKey % VoxelMap::chunkVoxels] = 0;
+        openNodes.push(NodeKey{Connectivity::estimate(Finish.xPos - Start.xPos, Finish.yPos - Start.yPos,
+            Finish.zPos - Start.zPos), startKey});
+        ++heapOperations;
+
+        while(!openNodes.empty()) {
+            const int n0Key = openNodes.top().index;
+            openNodes.pop();
+            ++heapOperations;
+            NodeChunk& n0Chunk = getNodeChunk(n0Key);
+            const int n0Local = n0Key % VoxelMap::chunkVoxels;
+            uint64_t& closedWord = n0Chunk.closed[n0Local >> 6];
+            if(closedWord >> (n0Local & 63) & 1) { continue; } // an old entry of a node closed with a better G(n)
+            closedWord |= uint64_t(1) << (n0Local & 63);
+            const int n0Level = n0Chunk.levels[n0Local];
+            ++expandedNodes;
+
+            // quit searching when the goal state is reached
+            if(n0Key == finishKey) {
+                // the voxels from the finish back to the start, reversed
+                std::vector<Position3D> route;
+                routeCost = n0Level;
+                for(int key = finishKey; ; ) {
+                    const Position3D p = map.getPosition(key);
+                    route.push_back(p);
+                    if(key == startKey) { break; }
+                    const int j = getNodeChunk(key).moves[key % VoxelMap::chunkVoxels];
+                    key = map.getKey(p.xPos - dx3[j], p.yPos - dy3[j], p.zPos - dz3[j]);
+                }
+                std::reverse(route.begin(), route.end());
+                return route;
+            }
+
+            // generate moves (child nodes) in all possible directions
+            const Position3D n0 = map.getPosition(n0Key);
+            for(int i = 0; i < Connectivity::count; ++i) {
+                const int x = n0.xPos + dx3[i], y = n0.yPos + dy3[i], z = n0.zPos + dz3[i];
+                if(map.isObstacle(x, y, z)) { continue; }
+                const int childKey = map.getKey(x, y, z);
+                NodeChunk& childChunk = getNodeChunk(childKey);
+                const int childLocal = childKey % VoxelMap::chunkVoxels;
+                if(childChunk.closed[childLocal >> 6] >> (childLocal & 63) & 1) { continue; }
+
+                // F(n) = G(n) + H(n). the open list keeps the better entry, the old one is skipped when popped
+                const int m0Level = n0Level + voxelStepCost(i);
+                int& level = childChunk.levels[childLocal];
+                if(level != -1 && level <= m0Level) { continue; }
+                level = m0Level;
+                childChunk.moves[childLocal] = i;
+                openNodes.push(NodeKey{m0Level + Connectivity::estimate(Finish.xPos - x, Finish.yPos - y, Finish.zPos - z),
+                    childKey});
+                ++heapOperations;
+            }
+        }
+        return std::vector<Position3D>(); // no route found
+    }
+};
+
+#endif // _VOXELPATHFINDER_
@@ -8,197 +8,840 @@ is the process of finding a path between multiple points, called "nodes". It enj
 However, in practical travel-routing systems, it is generally outperformed by algorithms which can pre-process the graph to attain 
 better performance, although other work has found A* to be superior to other approaches.
 
-In this version a struct is used to simplify the 2D-positions manipulation.*/
+In this version a struct is used to simplify the 2D-positions manipulation.
+The map is a GridMap sized at runtime and the search is done by PathFinder objects, which keep all their state inside, so many of
+them can be alive at the same time. The heuristic, the connectivity (Heuristics.h) and the open list are template parameters of
+PathFinder.
+Jump Point Search (JPS) and JPS+ (JumpPointSearch.h) solve the same routes on 8-connected maps pushing only the jump points.
+HPA* (HierarchicalPathFinder.h) searches long routes in a precomputed graph of cluster entrances and refines them later.
+The routes are returned in a compact run-length form (Route.h), the string of direction digits is only a view of it.
+BatchPathFinder.h solves a batch of queries with a pool of worker threads (compile with -pthread).
+HDA* (HashDistributedPathFinder.h) searches one long query with many threads, the cells are shared out between them by a hash.
+Bidirectional A* (BidirectionalPathFinder.h) searches from both ends at the same time and joins the two halves of the route.
+D* Lite (DStarLitePathFinder.h) repairs the last route when some cells change instead of searching again from scratch.
+ALT (Landmarks.h) is PathFinder with a heuristic of precomputed landmark distances, they can be saved to a file for the next runs.
+ARA* (AnytimePathFinder.h) returns the best route it finds before a deadline, with a bound of how far from optimal it is.
+A PathFinder search can also be time-sliced (startSearch, then step or runFor), to spread long searches over the frames of a game.
+Flow fields (FlowFieldPathFinder.h) give the next step of every cell to a finish shared by many units.
+WHCA* (CooperativePathFinder.h) plans a batch of units at once in space-time, so their routes do not collide.
+The connected components of the map (ConnectedComponents.h) let PathFinder reject an unreachable finish without searching.
+Lazy Theta* (AnyAnglePathFinder.h) returns any-angle routes as a few waypoints joined by lines of sight.
+Fringe search (FringePathFinder.h) keeps only the nodes it visits instead of node maps of the whole map, for the biggest maps.
+VoxelPathFinder.h searches 3D volumes (VoxelMap.h, chunked bit-packed voxels) with 6, 18 or 26 neighbours, for the flying units.
+The terrain mode adds traversal costs to the cells (grass, roads and mud) and searches with the WeightedTerrain policy.
+
+Usage: AlgoritmoAStarV2 [astar|jps|jps+|hpa|bidirectional|dstar|alt|ara|flowfield|whca|theta|fringe|terrain|
+    voxel|benchmark] [mapWidth mapHeight] [tablesFile]
+The alt mode loads its landmark tables from tablesFile when it is given, or builds them and saves them there. Without it nothing
+is written, the tables are built in every run.
+The voxel mode searches routes in a 512x512x512 volume of buildings, it is not displayed.
+Run the program with the "benchmark" argument to compare the expanded nodes per second of every open list and search mode.
+The Moving AI .map/.scen files (ScenarioLoader.h) are benchmarked by the PathfindingBenchmark program.*/
 
 #include <iostream>
 #include <iomanip>
-#include <queue>
 #include <string>
-#include <math.h>
+#include <cstdlib>
+#include <cctype>
 #include <ctime>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <limits>
+#include "GridMap.h"
+#include "PathFinder.h"
+#include "JumpPointSearch.h"
+#include "HierarchicalPathFinder.h"
+#include "BatchPathFinder.h"
+#include "BidirectionalPathFinder.h"
+#include "DStarLitePathFinder.h"
+#include "Landmarks.h"
+#include "AnytimePathFinder.h"
+#include "FlowFieldPathFinder.h"
+#include "CooperativePathFinder.h"
+#include "AnyAnglePathFinder.h"
+#include "FringePathFinder.h"
+#include "HashDistributedPathFinder.h"
+#include "VoxelPathFinder.h"
 using namespace std;
 
-#define mapWidth 60 // horizontal size of the map
-#define mapHeight 60 // vertical size size of the map
-static int map[mapWidth][mapHeight];
-static int closedNodesMap[mapWidth][mapHeight]; // map of closed (tried-out) nodes
-static int openNodesMap[mapWidth][mapHeight]; // map of open (not-yet-tried) nodes
-static int directionsMap[mapWidth][mapHeight]; // map of directions
-#define directions 8 // number of possible directions to go at any position
-#if directions==4
-static int dx[directions]={1, 0, -1, 0};
-static int dy[directions]={0, 1, 0, -1};
-#elif directions==8
-static int dx[directions] = {1, 1, 0, -1, -1, -1, 0, 1};
-static int dy[directions] = {0, 1, 1, 1, 0, -1, -1, -1};
-#endif // directions
 static char tips[5] = {'.', 'O'/*obstacle*/, 'S'/*start*/, 'R'/*route*/, 'F'/*finish*/};
 
-struct Position2D{
-public:
-    int xPos, yPos;
-    Position2D(const int xPos, const int yPos) : xPos(xPos), yPos(yPos) {}
-    Position2D(const Position2D& Value) : Position2D(Value.xPos, Value.yPos) {}
-    bool operator==(const Position2D& Other){ return xPos == Other.xPos && yPos == Other.yPos; }
-} static CurrentLoc(0,0);
-
-class Node {
-private:
-    Position2D Location;
-    int level; // total distance already travelled to reach the Node. named G(n)
-    int priority;  // priority=level+remaining distance estimate // smaller: higher priority. named H(n)
-public:
-    Node(const Position2D& Pos, const int level, const int priority) : Location(Pos), level(level), priority(priority){}
-    Position2D getLocation() const {return Location;}
-    int getxPos() const {return Location.xPos;}
-    int getyPos() const {return Location.yPos;}
-    int getLevel() const {return level;}
-    int getPriority() const {return priority;}
-    //F(n) = G(n) + H(n)
-    void updatePriority(const Position2D& DestLocation) { priority = level + estimate(DestLocation) * 10; /*A**/ }
-
-    // give better priority to going strait instead of diagonally
-    void nextLevel(const int direction) {
-        level += (directions == 8 ? (direction % 2 == 0 ? 10 : 14) : 10);
-    }
-
-    // Estimation function for the remaining distance to the goal.
-    int estimate(const Position2D& DestLocation) const {
-        const int xd = DestLocation.xPos - Location.xPos;
-        const int yd = DestLocation.yPos - Location.yPos;
-		// Euclidian Distance. Pitagoras: h^2=a^2+b^2
-        const int distance = static_cast<int>(sqrt(xd * xd + yd * yd)); 
-		// Manhattan distance if x=(a,b) and y=(c,d), the Manhattan distance between x and y is |a−c|+|b−d|
-        //const int distance = abs(xd) + abs(yd); 
-		// Chebyshev distance
-        //const int distance = max(abs(xd), abs(yd)); 
-        return distance;
-    }
-};
-
-// Determine priority (in the priority queue)
-bool operator<(const Node& a, const Node& b) { return a.getPriority() > b.getPriority(); }
-
-// A-star algorithm. // The route returned is a string of direction digits.
-string pathFind(const Position2D& Start, const Position2D& Finish) {
-    static priority_queue<Node> pq[2]; // list of open (not-yet-tried) nodes
-    static int pqi; // pq index
-    static Node* n0;
-    static Node* m0;
-    static int i, j, xdx, ydy;
-    static char c;
-    pqi = 0;
-
-    // reset the Node maps
-    int& y = CurrentLoc.yPos;
-    int& x = CurrentLoc.xPos;
-    for(y = 0; y < mapHeight; ++y) {
-        for(x = 0; x < mapWidth; ++x) {
-            closedNodesMap[x][y] = 0;
-            openNodesMap[x][y] = 0;
+// the start and finish locations used by main. RouteCase goes from 0 to 7
+void selectRoute(const GridMap& Map, const int RouteCase, Position2D& Start, Position2D& Finish) {
+    const int mapWidth = Map.getWidth();
+    const int mapHeight = Map.getHeight();
+    int& xA = Start.xPos;
+    int& yA = Start.yPos;
+    int& xB = Finish.xPos;
+    int& yB = Finish.yPos;
+    switch(RouteCase) {
+        case 0: xA = 0; yA = 0; xB = mapWidth - 1; yB = mapHeight - 1; break;
+        case 1: xA = 0; yA = mapHeight - 1; xB = mapWidth - 1; yB = 0; break;
+        case 2: xA = mapWidth / 2 - 1; yA = mapHeight / 2 - 1; xB = mapWidth / 2 + 1; yB = mapHeight / 2 + 1; break;
+        case 3: xA = mapWidth / 2 - 1; yA = mapHeight / 2 + 1; xB = mapWidth / 2 + 1; yB = mapHeight / 2 - 1; break;
+        case 4: xA = mapWidth / 2 - 1; yA = 0; xB = mapWidth / 2 + 1; yB = mapHeight - 1; break;
+        case 5: xA = mapWidth / 2 + 1; yA = mapHeight - 1; xB = mapWidth / 2 - 1; yB = 0; break;
+        case 6: xA = 0; yA = mapHeight / 2 - 1; xB = mapWidth - 1; yB = mapHeight / 2 + 1; break;
+        case 7: xA = mapWidth - 1; yA = mapHeight / 2 + 1; xB = 0; yB = mapHeight / 2 - 1; break;
+    }
+}
+
+// solve every route case many times and print the expanded nodes per second of a pathfinder
+template<class Finder>
+void benchmarkFinder(Finder& finder, const char* Name, const int Repetitions) {
+    const GridMap& Map = finder.getMap();
+    Position2D Start(0, 0), Finish(0, 0);
+    long long expansions = 0, routesCost = 0;
+    const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for(int r = 0; r < Repetitions; ++r) {
+        for(int routeCase = 0; routeCase < 8; ++routeCase) {
+            selectRoute(Map, routeCase, Start, Finish);
+            routesCost += finder.findRoute(Start, Finish).getCost(Map, Start);
+            expansions += finder.getExpandedNodes();
         }
     }
+    const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << setw(20) << left << Name << right << setw(12) << expansions << setw(12) << fixed << setprecision(3) << seconds 
+        << setw(16) << setprecision(0) << expansions / seconds << setw(12) << routesCost << endl;
+}
 
-    // create the start Node and push into list of open nodes
-    n0 = new Node(Start, 0, 0);
-    n0->updatePriority(Finish);
-    pq[pqi].push(*n0);
-    openNodesMap[x][y] = n0->getPriority(); // mark it on the open nodes map
-
-    // A* search
-    while(!pq[pqi].empty()) {
-        // get the current Node w/ the highest priority from the list of open nodes
-        const Node& currentNode = pq[pqi].top();
-        n0 = new Node(currentNode.getLocation(), currentNode.getLevel(), currentNode.getPriority());
-
-        x = n0->getxPos();
-        y = n0->getyPos();
-
-        pq[pqi].pop(); // remove the Node from the open list
-        openNodesMap[x][y] = 0;
-        closedNodesMap[x][y] = 1; // mark it on the closed nodes map
-
-        // quit searching when the goal state is reached
-        //if((*n0).estimate(Finish) == 0)
-        if(CurrentLoc == Finish){
-            // generate the path from finish to start by following the directions
-            string path = "";
-            while(!(CurrentLoc == Start)) {
-                j = directionsMap[x][y];
-                c = '0' + (j + directions / 2) % directions;
-                path = c + path;
-                x += dx[j];
-                y += dy[j];
-            }
+// random queries between free cells solved by pathFindBatch with 1, 2, 4... threads. the routes must be the same for all of them
+void runBatchBenchmark(const GridMap& Map) {
+    const int queriesCount = 2000;
+    srand(queriesCount); // the same queries in every run
+    vector<pair<Position2D, Position2D> > queries;
+    while(static_cast<int>(queries.size()) < queriesCount) {
+        const Position2D Start(rand() % Map.getWidth(), rand() % Map.getHeight());
+        const Position2D Finish(rand() % Map.getWidth(), rand() % Map.getHeight());
+        if(!Map.isObstacle(Start.xPos, Start.yPos) && !Map.isObstacle(Finish.xPos, Finish.yPos)) {
+            queries.push_back(make_pair(Start, Finish));
+        }
+    }
 
-            delete n0; // garbage collection
-            // empty the leftover nodes
-            while(!pq[pqi].empty()) { pq[pqi].pop(); }
-            return path;
+    cout << endl << "Batch benchmark. " << queriesCount << " random queries" << endl;
+    cout << setw(20) << left << "Threads" << right << setw(12) << "Expansions" << setw(12) << "Seconds" << setw(16)
+        << "Queries/s" << setw(12) << "Speedup" << endl;
+    const int maxThreads = max(static_cast<int>(thread::hardware_concurrency()), 1);
+    vector<string> firstRoutes;
+    double firstSeconds = 0.0;
+    for(int threads = 1; ; threads = min(threads * 2, maxThreads)) {
+        BatchPathFinder<> batchFinder(Map, threads);
+        const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        const vector<string> routes = batchFinder.pathFindBatch(queries);
+        const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if(threads == 1) {
+            firstRoutes = routes;
+            firstSeconds = seconds;
         }
+        cout << setw(20) << left << threads << right << setw(12) << batchFinder.getExpandedNodes() << setw(12) << fixed 
+            << setprecision(3) << seconds << setw(16) << setprecision(0) << queriesCount / seconds << setw(12) << setprecision(2)
+            << firstSeconds / seconds << (routes == firstRoutes ? "" : "  different routes!") << endl;
+        if(threads == maxThreads) { break; }
+    }
+}
+
+/* one long query on a big random map, searched by PathFinder and by HDA* with 1, 2, 4... threads. the speedup is against
+PathFinder, and the route costs must be the same */
+void runParallelBenchmark() {
+    const int mapSize = 1024;
+    GridMap bigMap(mapSize, mapSize);
+    srand(mapSize); // the same map in every run
+    for(int i = 0; i < mapSize * mapSize / 4; ++i) { bigMap.setObstacle(rand() % mapSize, rand() % mapSize, true); }
+    const Position2D Start(0, 0), Finish(mapSize - 1, mapSize - 1);
+    bigMap.setObstacle(Start.xPos, Start.yPos, false);
+    bigMap.setObstacle(Finish.xPos, Finish.yPos, false);
+
+    cout << endl << "Parallel benchmark (HDA*). One query on a random " << mapSize << "x" << mapSize << " map" << endl;
+    cout << setw(20) << left << "Threads" << right << setw(12) << "Expansions" << setw(12) << "Seconds" << setw(16) << "Messages"
+        << setw(12) << "Speedup" << setw(12) << "Route cost" << endl;
+    PathFinder<OctileHeuristic> finder(bigMap);
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    const int routeCost = finder.findRoute(Start, Finish).getCost();
+    const double firstSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << setw(20) << left << "PathFinder" << right << setw(12) << finder.getExpandedNodes() << setw(12) << fixed
+        << setprecision(3) << firstSeconds << setw(16) << 0 << setw(12) << setprecision(2) << 1.0 << setw(12) << routeCost << endl;
+    const int maxThreads = max(static_cast<int>(thread::hardware_concurrency()), 4);
+    for(int threads = 1; threads <= maxThreads; threads *= 2) {
+        HashDistributedPathFinder<> parallelFinder(bigMap, threads);
+        start = chrono::steady_clock::now();
+        const int cost = parallelFinder.findRoute(Start, Finish).getCost();
+        const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << setw(20) << left << threads << right << setw(12) << parallelFinder.getExpandedNodes() << setw(12) << setprecision(3)
+            << seconds << setw(16) << parallelFinder.getSentMessages() << setw(12) << setprecision(2) << firstSeconds / seconds
+            << setw(12) << cost << (cost == routeCost ? "" : "  different cost!") << endl;
+    }
+}
+
+// the routes of the flying units in a volume, with one connectivity. the node chunks are kept between the routes
+template<class Connectivity>
+void benchmarkVoxels(const VoxelMap& Volume, const vector<pair<Position3D, Position3D> >& Routes, const string& Name) {
+    VoxelPathFinder<Connectivity> finder(Volume);
+    long long expansions = 0, routesCost = 0;
+    const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for(const pair<Position3D, Position3D>& route : Routes) {
+        if(!finder.findRoute(route.first, route.second).empty()) { routesCost += finder.getCost(); }
+        expansions += finder.getExpandedNodes();
+    }
+    const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << setw(20) << left << Name << right << setw(12) << expansions << setw(12) << fixed << setprecision(3) << seconds
+        << setw(16) << setprecision(1) << finder.getMemoryBytes() / 1048576.0 << setw(12) << routesCost << endl;
+}
+
+/* a 512x512x512 volume with random buildings (boxes from the ground) and random routes over them, searched with 6, 18 and 26
+neighbours. the memory of the volume and of the node chunks follows the chunks with obstacles and the chunks searched */
+void runVoxelBenchmark() {
+    const int volumeSize = 512, buildings = 400, routesCount = 4;
+    VoxelMap volume(volumeSize, volumeSize, volumeSize);
+    srand(volumeSize); // the same volume in every run
+    for(int b = 0; b < buildings; ++b) {
+        const int x = rand() % volumeSize, y = rand() % volumeSize;
+        volume.setBox(x, y, 0, x + 8 + rand() % 24, y + 8 + rand() % 24, 16 + rand() % 160, true);
+    }
+    vector<pair<Position3D, Position3D> > routes;
+    while(static_cast<int>(routes.size()) < routesCount) {
+        const Position3D start(rand() % volumeSize, rand() % volumeSize, rand() % 64);
+        const Position3D finish(rand() % volumeSize, rand() % volumeSize, rand() % 64);
+        if(!volume.isObstacle(start.xPos, start.yPos, start.zPos) && !volume.isObstacle(finish.xPos, finish.yPos, finish.zPos)) {
+            routes.push_back(make_pair(start, finish));
+        }
+    }
+
+    cout << endl << "Voxel benchmark. " << routesCount << " routes in a " << volumeSize << "x" << volumeSize << "x" << volumeSize
+        << " volume, " << volume.getChunksCount() << " chunks, occupancy " << fixed << setprecision(1)
+        << volume.getMemoryBytes() / 1048576.0 << " MB" << endl;
+    cout << setw(20) << left << "Neighbours" << right << setw(12) << "Expansions" << setw(12) << "Seconds" << setw(16)
+        << "Nodes MB" << setw(12) << "Routes cost" << endl;
+    benchmarkVoxels<SixConnected>(volume, routes, "6 (faces)");
+    benchmarkVoxels<EighteenConnected>(volume, routes, "18 (+ edges)");
+    benchmarkVoxels<TwentySixConnected>(volume, routes, "26 (+ corners)");
+}
+
+/* a unit walks from a corner to the opposite one while some random cells change every tick (doors, other units). D* Lite repairs
+its route and PathFinder searches it again from scratch. the map is copied, the changes do not reach the caller */
+void runReplanBenchmark(GridMap Map) {
+    const int changesPerTick = 4;
+    srand(changesPerTick); // the same changes in every run
+    Position2D Start(0, 0), Finish(0, 0);
+    selectRoute(Map, 0, Start, Finish);
+    DStarLitePathFinder dstarFinder(Map);
+    PathFinder<> scratchFinder(Map);
+    long long dstarExpansions = 0, scratchExpansions = 0;
+    double dstarSeconds = 0.0, scratchSeconds = 0.0;
+    int ticks = 0;
+    Route route = dstarFinder.findRoute(Start, Finish);
+    while(!route.empty() && !(Start == Finish)) {
+        // the unit takes one step and the map changes. the cells of the unit and the finish are never blocked
+        const int j = route.getRuns().front().direction;
+        Start = Position2D(Start.xPos + dx[j], Start.yPos + dy[j]);
+        for(int i = 0; i < changesPerTick; ++i) {
+            const Position2D cell(rand() % Map.getWidth(), rand() % Map.getHeight());
+            if(cell == Start || cell == Finish) { continue; }
+            Map.setObstacle(cell.xPos, cell.yPos, rand() % 4 == 0);
+        }
+        ++ticks;
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        route = dstarFinder.findRoute(Start, Finish);
+        dstarSeconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        dstarExpansions += dstarFinder.getExpandedNodes();
+
+        start = chrono::steady_clock::now();
+        scratchFinder.pathFind(Start, Finish);
+        scratchSeconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        scratchExpansions += scratchFinder.getExpandedNodes();
+    }
 
-        // generate moves (child nodes) in all possible directions
-        for(i = 0; i < directions; ++i) {
-            xdx = x + dx[i];
-            ydy = y + dy[i];
-
-            if(!(xdx < 0 || xdx > mapWidth - 1 || ydy < 0 || ydy > mapHeight - 1 || map[xdx][ydy] == 1 
-				|| closedNodesMap[xdx][ydy] == 1)) {
-                m0 = new Node(Position2D(xdx, ydy), n0->getLevel(), n0->getPriority()); // generate a child Node
-                m0->nextLevel(i);
-                m0->updatePriority(Finish);
-
-                // if it is not in the open list then add into that
-                int& openNode = openNodesMap[xdx][ydy];
-                int& direction = directionsMap[xdx][ydy];
-                const int& m0Priority = m0->getPriority();
-                if(openNode == 0) {
-                    openNode = m0Priority;
-                    pq[pqi].push(*m0);
-
-                    direction = (i + directions / 2) % directions; // mark its parent Node direction
+    cout << endl << "Replanning benchmark. " << ticks << " ticks, " << changesPerTick << " changed cells per tick" << endl;
+    cout << setw(20) << left << "Search" << right << setw(12) << "Expansions" << setw(12) << "Seconds" << endl;
+    cout << setw(20) << left << "D* Lite" << right << setw(12) << dstarExpansions << setw(12) << fixed << setprecision(3)
+        << dstarSeconds << endl;
+    cout << setw(20) << left << "PathFinder" << right << setw(12) << scratchExpansions << setw(12) << scratchSeconds << endl;
+}
+
+// ARA* with time budgets per query. the routes get cheaper and the bounds lower as the budget grows. the queries whose first
+// iteration does not end in time have no route
+void runAnytimeBenchmark(const GridMap& Map, const int Repetitions) {
+    const int budgets[] = {50, 100, 200, 400, 800, 0}; // microseconds per query. 0: no limit
+    AnytimePathFinder<> finder(Map);
+    cout << endl << "Anytime benchmark (ARA*, weight 3.0 to 1.0)" << endl;
+    cout << setw(20) << left << "Budget per query" << right << setw(12) << "Expansions" << setw(12) << "Solved" << setw(16)
+        << "Mean bound" << setw(12) << "Routes cost" << endl;
+    for(const int budget : budgets) {
+        finder.setTimeBudget(chrono::microseconds(budget));
+        Position2D Start(0, 0), Finish(0, 0);
+        long long expansions = 0, routesCost = 0;
+        int solved = 0;
+        double boundSum = 0.0;
+        for(int r = 0; r < Repetitions; ++r) {
+            for(int routeCase = 0; routeCase < 8; ++routeCase) {
+                selectRoute(Map, routeCase, Start, Finish);
+                routesCost += finder.findRoute(Start, Finish).getCost();
+                expansions += finder.getExpandedNodes();
+                if(finder.getBound() > 0.0) {
+                    ++solved;
+                    boundSum += finder.getBound();
                 }
-                else if(openNode > m0Priority)
-                {
-                    openNode = m0Priority; // update the priority info
-                    direction = (i + directions / 2) % directions; // update the parent direction info
-
-                    /* replace the Node by emptying one pq to the other one except the Node to be replaced will be ignored and the 
-					new Node will be pushed in instead */
-                    const Node& replaceNode = pq[pqi].top();
-                    while(!(replaceNode.getLocation() == Position2D(xdx, ydy))) {
-                        pq[1 - pqi].push(replaceNode);
-                        pq[pqi].pop();
-                    }
-                    pq[pqi].pop(); // remove the wanted Node
-
-                    // empty the larger size pq to the smaller one
-                    if(pq[pqi].size() > pq[1 - pqi].size()) { pqi = 1 - pqi; }
-                    while(!pq[pqi].empty()) {
-                        pq[1 - pqi].push(pq[pqi].top());
-                        pq[pqi].pop();
-                    }
-                    pqi = 1 - pqi;
-                    pq[pqi].push(*m0); // add the better Node instead
+            }
+        }
+        const string name = budget == 0 ? string("no limit") : to_string(budget) + " us";
+        cout << setw(20) << left << name << right << setw(12) << expansions << setw(12) << solved << setw(16) << fixed
+            << setprecision(3) << (solved > 0 ? boundSum / solved : 0.0) << setw(12) << routesCost << endl;
+    }
+}
+
+// the 8 routes of selectRoute searched at the same time, in one frame or spread over frames with a budget of expansions per frame
+void runTimeSlicedBenchmark(const GridMap& Map) {
+    const int budgets[] = {0, 20000, 5000, 1000}; // expansions per frame, shared by the pending searches. 0: no limit
+    vector<unique_ptr<PathFinder<> > > finders;
+    for(int routeCase = 0; routeCase < 8; ++routeCase) { finders.emplace_back(new PathFinder<>(Map)); }
+
+    cout << endl << "Time-sliced benchmark. " << finders.size() << " searches spread over frames" << endl;
+    cout << setw(20) << left << "Budget per frame" << right << setw(12) << "Expansions" << setw(12) << "Frames" << setw(16)
+        << "Max per frame" << setw(16) << "Worst frame us" << setw(12) << "Routes cost" << endl;
+    for(const int budget : budgets) {
+        Position2D Start(0, 0), Finish(0, 0);
+        for(int routeCase = 0; routeCase < 8; ++routeCase) {
+            selectRoute(Map, routeCase, Start, Finish);
+            finders[routeCase]->startSearch(Start, Finish);
+        }
+
+        // every frame the budget is split evenly between the pending searches
+        int frames = 0;
+        long long expansions = 0, maxExpansions = 0, worstFrame = 0;
+        for(int pending = finders.size(); pending > 0; ) {
+            const long long share = budget == 0 ? numeric_limits<long long>::max() : max(budget / pending, 1);
+            const chrono::steady_clock::time_point frameStart = chrono::steady_clock::now();
+            pending = 0;
+            long long frameExpansions = 0;
+            for(unique_ptr<PathFinder<> >& finder : finders) {
+                if(finder->getStatus() != SearchStatus::pending) { continue; }
+                const long long lastExpansions = finder->getExpandedNodes();
+                if(finder->step(share) == SearchStatus::pending) { ++pending; }
+                frameExpansions += finder->getExpandedNodes() - lastExpansions;
+            }
+            const chrono::steady_clock::duration frameTime = chrono::steady_clock::now() - frameStart;
+            expansions += frameExpansions;
+            maxExpansions = max(maxExpansions, frameExpansions);
+            worstFrame = max(worstFrame, static_cast<long long>(chrono::duration_cast<chrono::microseconds>(frameTime).count()));
+            ++frames;
+        }
+
+        long long routesCost = 0;
+        for(const unique_ptr<PathFinder<> >& finder : finders) { routesCost += finder->getRoute().getCost(); }
+        const string name = budget == 0 ? string("no limit") : to_string(budget);
+        cout << setw(20) << left << name << right << setw(12) << expansions << setw(12) << frames << setw(16) << maxExpansions
+            << setw(16) << worstFrame << setw(12) << routesCost << endl;
+    }
+}
+
+// the any-angle routes of Lazy Theta* against the 8 directions routes of A*: their cost and their size
+void runAnyAngleBenchmark(const GridMap& Map, const int Repetitions) {
+    PathFinder<OctileHeuristic> gridFinder(Map);
+    AnyAnglePathFinder anyAngleFinder(Map);
+    long long gridExpansions = 0, gridCost = 0, gridCells = 0, anyAngleExpansions = 0, anyAngleCost = 0, waypoints = 0;
+    long long lineOfSightChecks = 0;
+    Position2D Start(0, 0), Finish(0, 0);
+    const clock_t gridStart = clock();
+    for(int r = 0; r < Repetitions; ++r) {
+        for(int routeCase = 0; routeCase < 8; ++routeCase) {
+            selectRoute(Map, routeCase, Start, Finish);
+            const Route route = gridFinder.findRoute(Start, Finish);
+            gridExpansions += gridFinder.getExpandedNodes();
+            gridCost += route.getCost();
+            gridCells += route.size();
+        }
+    }
+    const double gridSeconds = static_cast<double>(clock() - gridStart) / CLOCKS_PER_SEC;
+    const clock_t anyAngleStart = clock();
+    for(int r = 0; r < Repetitions; ++r) {
+        for(int routeCase = 0; routeCase < 8; ++routeCase) {
+            selectRoute(Map, routeCase, Start, Finish);
+            waypoints += anyAngleFinder.findWaypoints(Start, Finish).size();
+            anyAngleExpansions += anyAngleFinder.getExpandedNodes();
+            lineOfSightChecks += anyAngleFinder.getLineOfSightChecks();
+            anyAngleCost += anyAngleFinder.getCost();
+        }
+    }
+    const double anyAngleSeconds = static_cast<double>(clock() - anyAngleStart) / CLOCKS_PER_SEC;
+
+    cout << endl << "Any-angle benchmark (Lazy Theta*, " << lineOfSightChecks << " lines of sight)" << endl;
+    cout << setw(20) << left << "Search" << right << setw(12) << "Expansions" << setw(12) << "Seconds" << setw(16) << "Route points"
+        << setw(12) << "Routes cost" << endl;
+    cout << setw(20) << left << "A* (octile)" << right << setw(12) << gridExpansions << setw(12) << fixed << setprecision(3)
+        << gridSeconds << setw(16) << gridCells << setw(12) << gridCost << endl;
+    cout << setw(20) << left << "Lazy Theta*" << right << setw(12) << anyAngleExpansions << setw(12) << anyAngleSeconds
+        << setw(16) << waypoints << setw(12) << anyAngleCost << endl;
+}
+
+// the memory of the searches, in bytes: the node maps of A* are as big as the map, the fringe search only keeps the nodes it visits
+void runFringeBenchmark(const GridMap& Map, const int Repetitions) {
+    PathFinder<OctileHeuristic> gridFinder(Map);
+    FringePathFinder<> fringeFinder(Map);
+    long long gridExpansions = 0, gridCost = 0, fringeExpansions = 0, fringeCost = 0;
+    size_t fringeBytes = 0;
+    Position2D Start(0, 0), Finish(0, 0);
+    const clock_t gridStart = clock();
+    for(int r = 0; r < Repetitions; ++r) {
+        for(int routeCase = 0; routeCase < 8; ++routeCase) {
+            selectRoute(Map, routeCase, Start, Finish);
+            gridCost += gridFinder.findRoute(Start, Finish).getCost();
+            gridExpansions += gridFinder.getExpandedNodes();
+        }
+    }
+    const double gridSeconds = static_cast<double>(clock() - gridStart) / CLOCKS_PER_SEC;
+    const clock_t fringeStart = clock();
+    for(int r = 0; r < Repetitions; ++r) {
+        for(int routeCase = 0; routeCase < 8; ++routeCase) {
+            selectRoute(Map, routeCase, Start, Finish);
+            fringeCost += fringeFinder.findRoute(Start, Finish).getCost();
+            fringeExpansions += fringeFinder.getExpandedNodes();
+            fringeBytes = max(fringeBytes, fringeFinder.getMemoryBytes());
+        }
+    }
+    const double fringeSeconds = static_cast<double>(clock() - fringeStart) / CLOCKS_PER_SEC;
+
+    cout << endl << "Low memory benchmark (bytes: the node maps of A*, or the most of a fringe search)" << endl;
+    cout << setw(20) << left << "Search" << right << setw(12) << "Expansions" << setw(12) << "Seconds" << setw(16) << "Bytes"
+        << setw(12) << "Routes cost" << endl;
+    cout << setw(20) << left << "A* (octile)" << right << setw(12) << gridExpansions << setw(12) << fixed << setprecision(3)
+        << gridSeconds << setw(16) << gridFinder.getMemoryBytes() << setw(12) << gridCost << endl;
+    cout << setw(20) << left << "Fringe search" << right << setw(12) << fringeExpansions << setw(12) << fringeSeconds
+        << setw(16) << fringeBytes << setw(12) << fringeCost << endl;
+}
+
+// many units from random free cells to the same finish: a PathFinder search per unit, or one flow field for all of them
+void runFlowFieldBenchmark(const GridMap& Map) {
+    const int unitsCount = 500;
+    srand(unitsCount); // the same units in every run
+    Position2D Start(0, 0), Finish(0, 0);
+    selectRoute(Map, 0, Start, Finish);
+    vector<Position2D> units;
+    while(static_cast<int>(units.size()) < unitsCount) {
+        const Position2D unit(rand() % Map.getWidth(), rand() % Map.getHeight());
+        if(!Map.isObstacle(unit.xPos, unit.yPos)) { units.push_back(unit); }
+    }
+
+    cout << endl << "Flow field benchmark. " << unitsCount << " units going to " << Finish.xPos << "," << Finish.yPos << endl;
+    cout << setw(20) << left << "Search" << right << setw(12) << "Expansions" << setw(12) << "Seconds" << setw(16) << "Routes cost" 
+        << endl;
+    PathFinder<> finder(Map);
+    long long expansions = 0, routesCost = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for(const Position2D& unit : units) {
+        routesCost += finder.findRoute(unit, Finish).getCost();
+        expansions += finder.getExpandedNodes();
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << setw(20) << left << "PathFinder per unit" << right << setw(12) << expansions << setw(12) << fixed << setprecision(3)
+        << seconds << setw(16) << routesCost << endl;
+
+    FlowFieldPathFinder<> flowFinder(Map);
+    expansions = routesCost = 0;
+    start = chrono::steady_clock::now();
+    for(const Position2D& unit : units) {
+        routesCost += flowFinder.findRoute(unit, Finish).getCost();
+        expansions += flowFinder.getExpandedNodes();
+    }
+    seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << setw(20) << left << "Flow field" << right << setw(12) << expansions << setw(12) << seconds << setw(16) << routesCost
+        << endl;
+}
+
+// traversal costs: grass (3) everywhere, a road (1) every 10 rows and columns, and a band of mud (8) across the middle
+void addTerrain(GridMap& Map) {
+    for(int y = 0; y < Map.getHeight(); ++y) {
+        for(int x = 0; x < Map.getWidth(); ++x) {
+            const bool road = x % 10 == 5 || y % 10 == 5;
+            const bool mud = abs(x - y) < Map.getWidth() / 10;
+            Map.setCost(x, y, road ? 1 : (mud ? 8 : 3));
+        }
+    }
+}
+
+// the uniform fast path, the weighted terrain policy on a map without costs (its overhead), and on a map with terrain
+void runTerrainBenchmark(const GridMap& Map, const int Repetitions) {
+    cout << endl << "Terrain costs" << endl;
+    cout << setw(20) << left << "Search" << right << setw(12) << "Expansions" << setw(12) << "Seconds" << setw(16) 
+        << "Expansions/s" << setw(12) << "Routes cost" << endl;
+    PathFinder<OctileHeuristic> uniformFinder(Map);
+    benchmarkFinder(uniformFinder, "Uniform", Repetitions);
+    PathFinder<OctileHeuristic, defaultConnectivity, openList, WeightedTerrain> weightedFinder(Map);
+    benchmarkFinder(weightedFinder, "Weighted, no costs", Repetitions);
+    GridMap terrainMap(Map);
+    addTerrain(terrainMap);
+    PathFinder<OctileHeuristic, defaultConnectivity, openList, WeightedTerrain> terrainFinder(terrainMap);
+    benchmarkFinder(terrainFinder, "Weighted terrain", Repetitions);
+}
+
+/* queries to a finish walled off from the rest of the map, with and without the connected components, and the cost of keeping
+the components updated while random cells change. the map is copied, the changes do not reach the caller */
+void runComponentsBenchmark(GridMap Map, const int Repetitions) {
+    srand(Repetitions); // the same changes in every run
+    const Position2D Finish(Map.getWidth() / 4, Map.getHeight() / 4);
+    for(int i = 0; i < directions; ++i) { Map.setObstacle(Finish.xPos + dx[i] * 2, Finish.yPos + dy[i] * 2, true); }
+    for(int i = 0; i < directions; i += 2) { 
+        Map.setObstacle(Finish.xPos + dx[i] * 2 + dx[(i + 2) % directions], Finish.yPos + dy[i] * 2 + dy[(i + 2) % directions], true);
+        Map.setObstacle(Finish.xPos + dx[i] * 2 - dx[(i + 2) % directions], Finish.yPos + dy[i] * 2 - dy[(i + 2) % directions], true);
+    }
+    ConnectedComponents<> components(Map);
+
+    cout << endl << "Unreachable finish " << Finish.xPos << "," << Finish.yPos << " (walled off)" << endl;
+    cout << setw(20) << left << "Search" << right << setw(12) << "Expansions" << setw(12) << "Seconds" << endl;
+    PathFinder<> finder(Map);
+    for(int withComponents = 0; withComponents < 2; ++withComponents) {
+        finder.setComponents(withComponents == 1 ? &components : nullptr);
+        Position2D Start(0, 0), unused(0, 0);
+        long long expansions = 0;
+        const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for(int r = 0; r < Repetitions; ++r) {
+            for(int routeCase = 0; routeCase < 8; ++routeCase) {
+                selectRoute(Map, routeCase, Start, unused);
+                finder.findRoute(Start, Finish);
+                expansions += finder.getExpandedNodes();
+            }
+        }
+        const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << setw(20) << left << (withComponents == 1 ? "With components" : "Without components") << right << setw(12)
+            << expansions << setw(12) << fixed << setprecision(6) << seconds << endl;
+    }
+    // without the components, the fringe search keeps every node of the region of the start
+    FringePathFinder<> fringeFinder(Map);
+    for(int withComponents = 0; withComponents < 2; ++withComponents) {
+        fringeFinder.setComponents(withComponents == 1 ? &components : nullptr);
+        Position2D Start(0, 0), unused(0, 0);
+        selectRoute(Map, 0, Start, unused);
+        fringeFinder.findRoute(Start, Finish);
+        cout << setw(20) << left << (withComponents == 1 ? "Fringe, components" : "Fringe, none") << right << setw(12)
+            << fringeFinder.getExpandedNodes() << setw(12) << "" << setw(16) << fringeFinder.getCachedNodes() << " nodes kept"
+            << endl;
+    }
+
+    const int changes = 2000;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for(int i = 0; i < changes; ++i) {
+        Map.setObstacle(rand() % Map.getWidth(), rand() % Map.getHeight(), rand() % 4 == 0);
+        components.update();
+    }
+    const double updateSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    start = chrono::steady_clock::now();
+    components.build();
+    const double buildSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "Incremental update: " << setprecision(3) << updateSeconds * 1e6 / changes << " us per changed cell, full build: " 
+        << buildSeconds * 1e6 << " us" << endl;
+}
+
+// random units, each one going from a free cell to an other one. the first unit goes from Start to Finish
+vector<pair<Position2D, Position2D> > selectUnits(const GridMap& Map, const int Count, const Position2D& Start, 
+    const Position2D& Finish) {
+    vector<pair<Position2D, Position2D> > units(1, make_pair(Start, Finish));
+    vector<unsigned char> usedStarts(Map.getSize(), 0), usedFinishes(Map.getSize(), 0);
+    usedStarts[Map.getIndex(Start)] = usedFinishes[Map.getIndex(Finish)] = 1;
+    while(static_cast<int>(units.size()) < Count) {
+        const Position2D unitStart(rand() % Map.getWidth(), rand() % Map.getHeight());
+        const Position2D unitFinish(rand() % Map.getWidth(), rand() % Map.getHeight());
+        const int startIndex = Map.getIndex(unitStart), finishIndex = Map.getIndex(unitFinish);
+        if(Map.isObstacle(unitStart.xPos, unitStart.yPos) || Map.isObstacle(unitFinish.xPos, unitFinish.yPos) 
+            || usedStarts[startIndex] == 1 || usedFinishes[finishIndex] == 1) {
+            continue;
+        }
+        usedStarts[startIndex] = usedFinishes[finishIndex] = 1;
+        units.push_back(make_pair(unitStart, unitFinish));
+    }
+    return units;
+}
+
+// the cell of a unit at every step of a route
+vector<Position2D> getRouteCells(const Position2D& Start, const Route& Path) {
+    vector<Position2D> cells(1, Start);
+    for(const RouteRun& run : Path.getRuns()) {
+        for(int i = 0; i < run.count; ++i) {
+            cells.push_back(Position2D(cells.back().xPos + dx[run.direction], cells.back().yPos + dy[run.direction]));
+        }
+    }
+    return cells;
+}
+
+// many units planned one by one with PathFinder, ignoring each other, or together with WHCA*
+void runCooperativeBenchmark(const GridMap& Map) {
+    const int unitsCount = 100;
+    srand(unitsCount); // the same units in every run
+    Position2D Start(0, 0), Finish(0, 0);
+    selectRoute(Map, 0, Start, Finish);
+    const vector<pair<Position2D, Position2D> > units = selectUnits(Map, unitsCount, Start, Finish);
+
+    cout << endl << "Cooperative benchmark. " << unitsCount << " units with their own finishes" << endl;
+    cout << setw(20) << left << "Search" << right << setw(12) << "Expansions" << setw(12) << "Seconds" << setw(16) << "Collisions"
+        << setw(12) << "Arrived" << endl;
+    PathFinder<> finder(Map);
+    vector<vector<Position2D> > routes;
+    long long expansions = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for(const pair<Position2D, Position2D>& unit : units) {
+        routes.push_back(getRouteCells(unit.first, finder.findRoute(unit.first, unit.second)));
+        expansions += finder.getExpandedNodes();
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << setw(20) << left << "PathFinder per unit" << right << setw(12) << expansions << setw(12) << fixed << setprecision(3)
+        << seconds << setw(16) << CooperativePathFinder<>::countConflicts(routes) << setw(12) << unitsCount << endl;
+
+    for(const int window : {8, 16, 32}) {
+        CooperativePathFinder<> cooperativeFinder(Map, window, unitsCount); // a flow field per finish
+        start = chrono::steady_clock::now();
+        routes = cooperativeFinder.planRoutes(units, 50 * (Map.getWidth() + Map.getHeight()));
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        int arrived = 0;
+        for(int i = 0; i < unitsCount; ++i) { arrived += routes[i].back() == units[i].second ? 1 : 0; }
+        const string name = "WHCA* window " + to_string(window);
+        cout << setw(20) << left << name << right << setw(12) << cooperativeFinder.getExpandedNodes() << setw(12) << seconds 
+            << setw(16) << CooperativePathFinder<>::countConflicts(routes) << setw(12) << arrived << endl;
+    }
+}
+
+/* push and pop throughput of an open list holding Size nodes: every pop is followed by the push of a node with a priority 10 to 28
+higher, the steps of A* with a consistent heuristic */
+template<class OpenList>
+void benchmarkOpenList(const char* Name, const int Size, const int Operations) {
+    OpenList openNodes;
+    openNodes.resize(Size, 1);
+    unsigned int seed = Size; // the same priorities for every open list
+    for(int i = 0; i < Size; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        openNodes.push(NodeKey{static_cast<int>((seed >> 16) % 29), i});
+    }
+    long long checksum = 0; // the sum of the popped priorities, the same for every open list
+    const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for(int i = 0; i < Operations; ++i) {
+        const NodeKey node = openNodes.top();
+        openNodes.pop();
+        checksum += node.priority;
+        seed = seed * 1103515245u + 12345u;
+        openNodes.push(NodeKey{node.priority + 10 + static_cast<int>((seed >> 16) % 19), node.index});
+    }
+    const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << setw(20) << left << Name << right << setw(12) << Size << setw(12) << fixed << setprecision(3) << seconds << setw(16)
+        << setprecision(0) << Operations / seconds << setw(12) << checksum % 1000000 << endl;
+}
+
+void runOpenListBenchmark() {
+    const int operations = 2000000;
+    cout << endl << "Open lists, pop + push pairs" << endl;
+    cout << setw(20) << left << "Open list" << right << setw(12) << "Nodes" << setw(12) << "Seconds" << setw(16) << "Pairs/s" 
+        << setw(12) << "Checksum" << endl;
+    for(const int size : {100, 10000, 1000000}) {
+        benchmarkOpenList<TwoHeapOpenList>("Binary heap", size, operations);
+        benchmarkOpenList<IndexedHeapOpenList>("IndexedHeapOpenList", size, operations);
+        benchmarkOpenList<LazyHeapOpenList>("LazyHeapOpenList", size, operations);
+        benchmarkOpenList<BucketOpenList>("BucketOpenList", size, operations);
+    }
+}
+
+template<class Heuristic, class Connectivity>
+void benchmarkPolicies(const GridMap& Map, const char* Name, const int Repetitions) {
+    PathFinder<Heuristic, Connectivity> finder(Map);
+    benchmarkFinder(finder, Name, Repetitions);
+}
+
+// PathFinder with every heuristic and connectivity. the four connected routes cost more, they have no diagonal moves
+void runPoliciesBenchmark(const GridMap& Map, const int Repetitions) {
+    cout << endl << "Heuristics and connectivities" << endl;
+    cout << setw(20) << left << "Search" << right << setw(12) << "Expansions" << setw(12) << "Seconds" << setw(16) 
+        << "Expansions/s" << setw(12) << "Routes cost" << endl;
+#if directions==8
+    benchmarkPolicies<OctileHeuristic, EightConnected>(Map, "Octile 8", Repetitions);
+    benchmarkPolicies<ManhattanHeuristic, EightConnected>(Map, "Manhattan 8", Repetitions);
+    benchmarkPolicies<ChebyshevHeuristic, EightConnected>(Map, "Chebyshev 8", Repetitions);
+    benchmarkPolicies<EuclideanHeuristic, EightConnected>(Map, "Euclidean 8", Repetitions);
+#endif // directions
+    benchmarkPolicies<OctileHeuristic, FourConnected>(Map, "Octile 4", Repetitions);
+    benchmarkPolicies<ManhattanHeuristic, FourConnected>(Map, "Manhattan 4", Repetitions);
+    benchmarkPolicies<ChebyshevHeuristic, FourConnected>(Map, "Chebyshev 4", Repetitions);
+    benchmarkPolicies<EuclideanHeuristic, FourConnected>(Map, "Euclidean 4", Repetitions);
+}
+
+void runBenchmark(const GridMap& Map) {
+    const int repetitions = 50;
+    cout << "Pathfinding benchmark. " << repetitions << " x 8 routes on the " << Map.getWidth() << "x" << Map.getHeight() 
+        << " map" << endl;
+    cout << setw(20) << left << "Search" << right << setw(12) << "Expansions" << setw(12) << "Seconds" << setw(16) 
+        << "Expansions/s" << setw(12) << "Routes cost" << endl;
+    /* the open lists are compared with the octile estimate: it is consistent, so all of them find the shortest routes. the bucket
+    list needs it, with the default (truncated Euclidean) estimate its routes are not the shortest */
+    PathFinder<OctileHeuristic, defaultConnectivity, TwoHeapOpenList> twoHeapFinder(Map);
+    benchmarkFinder(twoHeapFinder, "TwoHeapOpenList", repetitions);
+    PathFinder<OctileHeuristic, defaultConnectivity, IndexedHeapOpenList> indexedHeapFinder(Map);
+    benchmarkFinder(indexedHeapFinder, "IndexedHeapOpenList", repetitions);
+    PathFinder<OctileHeuristic, defaultConnectivity, LazyHeapOpenList> lazyHeapFinder(Map);
+    benchmarkFinder(lazyHeapFinder, "LazyHeapOpenList", repetitions);
+    PathFinder<OctileHeuristic, defaultConnectivity, BucketOpenList> bucketFinder(Map);
+    benchmarkFinder(bucketFinder, "BucketOpenList", repetitions);
+    JumpPointPathFinder jpsFinder(Map, false);
+    benchmarkFinder(jpsFinder, "JPS", repetitions);
+    JumpPointPathFinder jpsPlusFinder(Map, true);
+    benchmarkFinder(jpsPlusFinder, "JPS+", repetitions);
+    HierarchicalPathFinder hpaFinder(Map);
+    benchmarkFinder(hpaFinder, "HPA*", repetitions);
+    BidirectionalPathFinder<> bidirectionalFinder(Map);
+    benchmarkFinder(bidirectionalFinder, "Bidirectional A*", repetitions);
+    LandmarkTables landmarkTables(Map);
+    landmarkTables.build(8);
+    PathFinder<LandmarkHeuristic> altFinder(Map, LandmarkHeuristic(landmarkTables));
+    benchmarkFinder(altFinder, "ALT (8 landmarks)", repetitions);
+    runOpenListBenchmark();
+    runPoliciesBenchmark(Map, repetitions);
+    runTerrainBenchmark(Map, repetitions);
+    runComponentsBenchmark(Map, repetitions);
+    runBatchBenchmark(Map);
+    runReplanBenchmark(Map);
+    runAnytimeBenchmark(Map, repetitions);
+    runTimeSlicedBenchmark(Map);
+    runAnyAngleBenchmark(Map, repetitions);
+    runFringeBenchmark(Map, repetitions);
+    runParallelBenchmark();
+    runVoxelBenchmark();
+    runFlowFieldBenchmark(Map);
+    runCooperativeBenchmark(Map);
+}
+
+// solve a route with a pathfinder and keep the number of nodes it expanded
+template<class Finder>
+Route solveRoute(Finder& finder, const Position2D& Start, const Position2D& Finish, long long& ExpandedNodes) {
+    const Route route = finder.findRoute(Start, Finish);
+    ExpandedNodes = finder.getExpandedNodes();
+    return route;
+}
+
+// solve a route with the search mode selected in the command line. TablesFile: the landmark tables of the alt mode, "": none
+Route solveRoute(const GridMap& Map, const string& Mode, const string& TablesFile, const Position2D& Start,
+    const Position2D& Finish, long long& ExpandedNodes) {
+    if(Mode == "jps" || Mode == "jps+") {
+        JumpPointPathFinder finder(Map, Mode == "jps+");
+        return solveRoute(finder, Start, Finish, ExpandedNodes);
+    }
+    if(Mode == "hpa") {
+        HierarchicalPathFinder finder(Map);
+        return solveRoute(finder, Start, Finish, ExpandedNodes);
+    }
+    if(Mode == "bidirectional") {
+        BidirectionalPathFinder<> finder(Map);
+        const Route route = solveRoute(finder, Start, Finish, ExpandedNodes);
+        cout << "Expanded nodes (forward, backward): " << finder.getForwardExpandedNodes() << ", " 
+            << finder.getBackwardExpandedNodes() << endl;
+        return route;
+    }
+    if(Mode == "dstar") {
+        // block the middle cell of the route in a copy of the map and repair the route
+        GridMap dynamicMap(Map);
+        DStarLitePathFinder finder(dynamicMap);
+        const Route route = solveRoute(finder, Start, Finish, ExpandedNodes);
+        if(route.size() < 2) { return route; }
+        int x = Start.xPos;
+        int y = Start.yPos;
+        int steps = route.size() / 2;
+        for(const RouteRun& run : route.getRuns()) {
+            const int count = min(run.count, steps);
+            x += dx[run.direction] * count;
+            y += dy[run.direction] * count;
+            steps -= count;
+        }
+        cout << "Expanded nodes of the first route: " << ExpandedNodes << endl;
+        cout << "Blocked cell: " << x << "," << y << endl;
+        dynamicMap.setObstacle(x, y, true);
+        return solveRoute(finder, Start, Finish, ExpandedNodes);
+    }
+    if(Mode == "alt") {
+        // the tables of a map are searched once and kept in the file asked for, for the next runs
+        LandmarkTables tables(Map);
+        if(!TablesFile.empty() && tables.load(TablesFile)) { cout << "Landmark tables loaded from " << TablesFile << endl; }
+        else {
+            tables.build(8);
+            if(!TablesFile.empty() && tables.save(TablesFile)) { cout << "Landmark tables saved to " << TablesFile << endl; }
+        }
+        PathFinder<LandmarkHeuristic> finder(Map, LandmarkHeuristic(tables));
+        return solveRoute(finder, Start, Finish, ExpandedNodes);
+    }
+    if(Mode == "ara") {
+        AnytimePathFinder<> finder(Map);
+        finder.setTimeBudget(chrono::microseconds(200));
+        const Route route = solveRoute(finder, Start, Finish, ExpandedNodes);
+        cout << "Iterations: " << finder.getIterations() << ", suboptimality bound: " << finder.getBound() << endl;
+        return route;
+    }
+    if(Mode == "flowfield") {
+        FlowFieldPathFinder<> finder(Map);
+        const Route route = solveRoute(finder, Start, Finish, ExpandedNodes);
+        cout << "Next step from the start: " << finder.nextDirection(Start, Finish) << " (field cached, "
+            << finder.getExpandedNodes() << " expanded nodes)" << endl;
+        return route;
+    }
+    if(Mode == "whca") {
+        // the route of the first unit, planned with 15 other units. the steps waiting for them are not shown
+        const vector<pair<Position2D, Position2D> > units = selectUnits(Map, 16, Start, Finish);
+        CooperativePathFinder<> finder(Map, 16, units.size());
+        const vector<vector<Position2D> > routes = finder.planRoutes(units, 50 * (Map.getWidth() + Map.getHeight()));
+        ExpandedNodes = finder.getExpandedNodes();
+        cout << "Units: " << units.size() << ", collisions: " << CooperativePathFinder<>::countConflicts(routes) 
+            << ", time steps of the first unit: " << routes[0].size() - 1 << endl;
+        Route route;
+        for(size_t t = 1; t < routes[0].size(); ++t) {
+            for(int i = 0; i < directions; ++i) {
+                if(routes[0][t - 1].xPos + dx[i] == routes[0][t].xPos && routes[0][t - 1].yPos + dy[i] == routes[0][t].yPos) {
+                    route.append(i);
                 }
-                else delete m0; // garbage collection
             }
         }
-        delete n0; // garbage collection
+        return route;
     }
-    return ""; // no route found
+    if(Mode == "fringe") {
+        FringePathFinder<> finder(Map);
+        const Route route = solveRoute(finder, Start, Finish, ExpandedNodes);
+        cout << "Iterations: " << finder.getIterations() << ", nodes kept: " << finder.getCachedNodes() << " of "
+            << Map.getSize() << " cells, " << finder.getMemoryBytes() << " bytes (A* node maps: "
+            << PathFinder<>(Map).getMemoryBytes() << ")" << endl;
+        return route;
+    }
+    if(Mode == "theta") {
+        AnyAnglePathFinder finder(Map);
+        const vector<Position2D> waypoints = finder.findWaypoints(Start, Finish);
+        ExpandedNodes = finder.getExpandedNodes();
+        cout << "Waypoints:";
+        for(const Position2D& waypoint : waypoints) { cout << " " << waypoint.xPos << "," << waypoint.yPos; }
+        cout << endl << "Any-angle cost: " << finder.getCost() << endl;
+        return AnyAnglePathFinder::toRoute(waypoints);
+    }
+    if(Mode == "terrain") {
+        GridMap terrainMap(Map); // the route is displayed over the map of main, without the costs
+        addTerrain(terrainMap);
+        PathFinder<OctileHeuristic, defaultConnectivity, openList, WeightedTerrain> finder(terrainMap);
+        const Route route = solveRoute(finder, Start, Finish, ExpandedNodes);
+        cout << "Terrain cost of the route: " << route.getCost(terrainMap, Start) << " (uniform cost " << route.getCost() << ")" 
+            << endl;
+        return route;
+    }
+    PathFinder<> finder(Map);
+    return solveRoute(finder, Start, Finish, ExpandedNodes);
 }
 
-int main()
+int main(int argc, char* argv[])
 {
     srand(time(0));
 
-    int& y = CurrentLoc.yPos;
-    int& x = CurrentLoc.xPos;
-    // create empty map. print in every map location a dot
-    for(y = 0; y < mapHeight; ++y) {
-        for(x = 0; x < mapWidth; ++x) { map[x][y] = 0; }
+    int argi = 1;
+    // search mode: astar, jps, jps+, hpa, bidirectional, dstar, alt, ara, flowfield, whca, theta, fringe, terrain, voxel or
+    // benchmark
+    string mode = "astar";
+    if(argc > argi && !isdigit(argv[argi][0])) { mode = argv[argi++]; }
+    int mapWidth = 60; // horizontal size of the map
+    int mapHeight = 60; // vertical size size of the map
+    if(argc > argi + 1 && isdigit(argv[argi][0])) {
+        mapWidth = max(atoi(argv[argi]), 8);
+        mapHeight = max(atoi(argv[argi + 1]), 8);
+        argi += 2;
     }
+    const string tablesFile = argc > argi ? argv[argi] : ""; // landmark tables file of the alt mode
+
+    // create empty map
+    GridMap map(mapWidth, mapHeight);
 
     //fillout the map matrix with a '+' pattern obstacles
     const int xn = mapWidth * 0.125; //1/8 = 0.125
@@ -207,56 +850,60 @@ int main()
     const int xm = mapHeight * 0.125;
     const int mm = xm * 7;
     const int xMapWidth = mapWidth * 0.5;
-    for(x = xn; x < nn; ++x) { map[x][xMapHeight] = 1; }
-    for(y = xm; y < mm; ++y) { map[xMapWidth][y] = 1; }
+    for(int x = xn; x < nn; ++x) { map.setObstacle(x, xMapHeight, true); }
+    for(int y = xm; y < mm; ++y) { map.setObstacle(xMapWidth, y, true); }
 
-    // randomly select start and finish locations
-    int xA, yA, xB, yB;
-    switch(rand() % 8) {
-        case 0: xA = 0; yA = 0; xB = mapWidth - 1; yB = mapHeight - 1; break;
-        case 1: xA = 0; yA = mapHeight - 1; xB = mapWidth - 1; yB = 0; break;
-        case 2: xA = mapWidth / 2 - 1; yA = mapHeight / 2 - 1; xB = mapWidth / 2 + 1; yB = mapHeight / 2 + 1; break;
-        case 3: xA = mapWidth / 2 - 1; yA = mapHeight / 2 + 1; xB = mapWidth / 2 + 1; yB = mapHeight / 2 - 1; break;
-        case 4: xA = mapWidth / 2 - 1; yA = 0; xB = mapWidth / 2 + 1; yB = mapHeight - 1; break;
-        case 5: xA = mapWidth / 2 + 1; yA = mapHeight - 1; xB = mapWidth / 2 - 1; yB = 0; break;
-        case 6: xA = 0; yA = mapHeight / 2 - 1; xB = mapWidth - 1; yB = mapHeight / 2 + 1; break;
-        case 7: xA = mapWidth - 1; yA = mapHeight / 2 + 1; xB = 0; yB = mapHeight / 2 - 1; break;
+    if(mode == "benchmark") {
+        runBenchmark(map);
+        return 0;
     }
+    if(mode == "voxel") {
+        runVoxelBenchmark();
+        return 0;
+    }
+
+    // randomly select start and finish locations
+    Position2D Start(0, 0), Finish(0, 0);
+    selectRoute(map, rand() % 8, Start, Finish);
 
+    cout << "Search mode: " << mode << endl;
     cout << "Map Size (X,Y): " << mapWidth << "," << mapHeight << endl;
-    cout << "Start: " << xA << "," << yA << endl;
-    cout << "Finish: " << xB << "," << yB << endl;
+    cout << "Start: " << Start.xPos << "," << Start.yPos << endl;
+    cout << "Finish: " << Finish.xPos << "," << Finish.yPos << endl;
 
     // get the route and calculate the time
+    long long expandedNodes = 0;
     clock_t start = clock();
-    string route = pathFind(Position2D(xA, yA), Position2D(xB, yB));
+    const Route route = solveRoute(map, mode, tablesFile, Start, Finish, expandedNodes);
     clock_t end = clock();
-    const int length = route.size();
-    if(length == 0) { cout << "An empty route generated!" << endl; }
+    if(route.empty()) { cout << "An empty route generated!" << endl; }
     const double time_elapsed = static_cast<double>(end - start);
     cout << "Time to calculate the route (ms): " << time_elapsed << endl;
-    cout << "Route:" << endl;
-    cout << route << endl << endl;
-
-    // follow the route on the map and display it
-    if(length > 0) {
-        int j;
-        char c;
-        x = xA;
-        y = yA;
-        map[x][y] = 2; //set the Start tip
-        for(int i = 0; i < length; ++i){
-            c = route.at(i);
-            j = atoi(&c);
-            x = x + dx[j];
-            y = y + dy[j];
-            map[x][y] = 3; //set the Route tip
+    cout << "Expanded nodes: " << expandedNodes << endl;
+    cout << "Route (direction x steps):" << endl;
+    for(const RouteRun& run : route.getRuns()) { cout << static_cast<int>(run.direction) << "x" << run.count << " "; }
+    cout << endl << route.toString() << endl << endl;
+
+    // follow the route on the map and display it. big maps are not displayed
+    if(!route.empty() && mapWidth <= 120) {
+        // the tips of the cells: the obstacles of the map, and the route over them
+        vector<unsigned char> cells(map.getSize());
+        for(int index = 0; index < map.getSize(); ++index) { cells[index] = map(index % mapWidth, index / mapWidth); }
+        int x = Start.xPos;
+        int y = Start.yPos;
+        cells[map.getIndex(x, y)] = 2; //set the Start tip
+        for(const RouteRun& run : route.getRuns()) {
+            for(int i = 0; i < run.count; ++i) {
+                x = x + dx[run.direction];
+                y = y + dy[run.direction];
+                cells[map.getIndex(x, y)] = 3; //set the Route tip
+            }
         }
-        map[x][y] = 4; //set the Finish tip
+        cells[map.getIndex(x, y)] = 4; //set the Finish tip
 
         // display the map with the route
         for(y = 0; y < mapHeight; ++y) {
-            for(x = 0; x < mapWidth; ++x){ cout << tips[map[x][y]]; }
+            for(x = 0; x < mapWidth; ++x){ cout << tips[cells[map.getIndex(x, y)]]; }
             cout << endl;
         }
     }
@@ -0,0 +1,288 @@
+/**
+Pathfinding benchmark suite of the AlgoritmoAStarV2 engines. https://movingai.com/benchmarks/
+Every scenario of a Moving AI .scen file (or a generated one) is solved by every search mode, and for every mode it reports the
+expanded nodes, the heap operations, the percentiles of the wall time per query and the optimality error. The error of a route is
+its cost divided by the optimal cost (an octile A* search, optimal with the costs of the engines) minus 1.
+The results can also be written as CSV, one line per mode, to compare the runs of the V2 engines before and after a change.
+AlgoritmoAStarV1 is not benchmarked: its map is a fixed 60x60 grid of static arrays, it can not search the loaded maps.
+
+Usage: PathfindingBenchmark [file.scen [file.map]] [--csv results.csv] [--modes astar,jps,...] [--budget microseconds]
+Without a .scen file a 256x256 map with the '+' obstacles and random walls is generated, with 1000 random scenarios.
+The .map file is taken from the .scen file when it is not given. --budget is the time per query of the anytime mode (ara), without
+it ara searches until its routes are optimal. Compile with -pthread, like AlgoritmoAStarV2. */
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <math.h>
+#include "../AlgoritmoAStarV2/GridMap.h"
+#include "../AlgoritmoAStarV2/PathFinder.h"
+#include "../AlgoritmoAStarV2/JumpPointSearch.h"
+#include "../AlgoritmoAStarV2/HierarchicalPathFinder.h"
+#include "../AlgoritmoAStarV2/BidirectionalPathFinder.h"
+#include "../AlgoritmoAStarV2/DStarLitePathFinder.h"
+#include "../AlgoritmoAStarV2/Landmarks.h"
+#include "../AlgoritmoAStarV2/AnytimePathFinder.h"
+#include "../AlgoritmoAStarV2/FringePathFinder.h"
+#include "../AlgoritmoAStarV2/ScenarioLoader.h"
+using namespace std;
+
+static const char* allModes = "astar,astar-octile,astar-bucket,jps,jps+,hpa,bidirectional,dstar,alt,ara,fringe";
+
+// the measures of one search mode over all the scenarios
+struct ModeResult {
+    string mode;
+    double setupSeconds = 0.0; // construction of the pathfinder (precomputed tables)
+    int queries = 0, solved = 0, failures = 0; // failures: invalid routes, or no route when there is one
+    long long expansions = 0, heapOperations = 0;
+    vector<double> microseconds; // wall time of every query
+    double errorSum = 0.0, maxError = 0.0; // optimality error of the solved queries
+
+    // nearest-rank percentile of the query times
+    double percentile(const double Percent) const {
+        if(microseconds.empty()) { return 0.0; }
+        vector<double> sorted(microseconds);
+        sort(sorted.begin(), sorted.end());
+        const size_t rank = static_cast<size_t>(ceil(Percent / 100.0 * sorted.size()));
+        return sorted[min(max(rank, static_cast<size_t>(1)), sorted.size()) - 1];
+    }
+
+    double meanError() const { return solved > 0 ? errorSum / solved : 0.0; }
+};
+
+// cost of a route walked over the map. -1 if it crosses an obstacle or it does not end at the finish
+int checkRoute(const GridMap& Map, const Position2D& Start, const Position2D& Finish, const Route& Path) {
+    int x = Start.xPos;
+    int y = Start.yPos;
+    for(const RouteRun& run : Path.getRuns()) {
+        for(int i = 0; i < run.count; ++i) {
+            x += dx[run.direction];
+            y += dy[run.direction];
+            if(!Map.isInside(x, y) || Map.isObstacle(x, y)) { return -1; }
+        }
+    }
+    return x == Finish.xPos && y == Finish.yPos ? Path.getCost() : -1;
+}
+
+// solve every scenario with a pathfinder. OptimalCosts: -1 when there is no route
+template<class Finder>
+void runScenarios(Finder& finder, const GridMap& Map, const vector<Scenario>& Scenarios, const vector<int>& OptimalCosts,
+    ModeResult& Result) {
+    for(size_t i = 0; i < Scenarios.size(); ++i) {
+        const Scenario& scenario = Scenarios[i];
+        const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        const Route route = finder.findRoute(scenario.Start, scenario.Finish);
+        Result.microseconds.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - start).count());
+        Result.expansions += finder.getExpandedNodes();
+        Result.heapOperations += finder.getHeapOperations();
+        ++Result.queries;
+
+        const int optimalCost = OptimalCosts[i];
+        if(route.empty() && !(scenario.Start == scenario.Finish)) {
+            if(optimalCost != -1) { ++Result.failures; }
+            continue;
+        }
+        const int cost = checkRoute(Map, scenario.Start, scenario.Finish, route);
+        if(cost == -1 || optimalCost == -1) {
+            ++Result.failures;
+            continue;
+        }
+        const double error = optimalCost > 0 ? static_cast<double>(cost) / optimalCost - 1.0 : 0.0;
+        ++Result.solved;
+        Result.errorSum += error;
+        Result.maxError = max(Result.maxError, error);
+    }
+}
+
+// build the pathfinder of a search mode and solve every scenario with it
+ModeResult runMode(const string& Mode, const GridMap& Map, const vector<Scenario>& Scenarios, const vector<int>& OptimalCosts,
+    const int Budget) {
+    ModeResult result;
+    result.mode = Mode;
+    const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    if(Mode == "astar") {
+        PathFinder<> finder(Map);
+        result.setupSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        runScenarios(finder, Map, Scenarios, OptimalCosts, result);
+    }
+    else if(Mode == "astar-octile") {
+        PathFinder<OctileHeuristic> finder(Map);
+        result.setupSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        runScenarios(finder, Map, Scenarios, OptimalCosts, result);
+    }
+    else if(Mode == "astar-bucket") {
+        PathFinder<OctileHeuristic, defaultConnectivity, BucketOpenList> finder(Map);
+        result.setupSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        runScenarios(finder, Map, Scenarios, OptimalCosts, result);
+    }
+    else if(Mode == "jps" || Mode == "jps+") {
+        JumpPointPathFinder finder(Map, Mode == "jps+");
+        result.setupSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        runScenarios(finder, Map, Scenarios, OptimalCosts, result);
+    }
+    else if(Mode == "hpa") {
+        HierarchicalPathFinder finder(Map);
+        result.setupSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        runScenarios(finder, Map, Scenarios, OptimalCosts, result);
+    }
+    else if(Mode == "bidirectional") {
+        BidirectionalPathFinder<> finder(Map);
+        result.setupSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        runScenarios(finder, Map, Scenarios, OptimalCosts, result);
+    }
+    else if(Mode == "dstar") {
+        DStarLitePathFinder finder(Map);
+        result.setupSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        runScenarios(finder, Map, Scenarios, OptimalCosts, result);
+    }
+    else if(Mode == "alt") {
+        LandmarkTables tables(Map);
+        tables.build(8);
+        PathFinder<LandmarkHeuristic> finder(Map, LandmarkHeuristic(tables));
+        result.setupSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        runScenarios(finder, Map, Scenarios, OptimalCosts, result);
+    }
+    else if(Mode == "ara") {
+        AnytimePathFinder<> finder(Map);
+        finder.setTimeBudget(chrono::microseconds(Budget));
+        result.setupSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        runScenarios(finder, Map, Scenarios, OptimalCosts, result);
+    }
+    else if(Mode == "fringe") {
+        FringePathFinder<> finder(Map);
+        result.setupSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        runScenarios(finder, Map, Scenarios, OptimalCosts, result);
+    }
+    else { cout << "Unknown search mode: " << Mode << endl; }
+    return result;
+}
+
+// the '+' obstacles of AlgoritmoAStarV2 and some random walls, with random scenarios between free cells
+void generateScenarios(GridMap& Map, vector<Scenario>& Scenarios, const int Count) {
+    const int mapWidth = Map.getWidth();
+    const int mapHeight = Map.getHeight();
+    srand(Count); // the same map and scenarios in every run
+    for(int x = mapWidth / 8; x < mapWidth / 8 * 7; ++x) { Map.setObstacle(x, mapHeight / 2, true); }
+    for(int y = mapHeight / 8; y < mapHeight / 8 * 7; ++y) { Map.setObstacle(mapWidth / 2, y, true); }
+    for(int wall = 0; wall < mapWidth / 4; ++wall) {
+        const int x = rand() % mapWidth;
+        const int y = rand() % mapHeight;
+        const int length = rand() % (mapWidth / 4);
+        const bool horizontal = rand() % 2 == 0;
+        for(int i = 0; i < length; ++i) {
+            if(horizontal && x + i < mapWidth) { Map.setObstacle(x + i, y, true); }
+            if(!horizontal && y + i < mapHeight) { Map.setObstacle(x, y + i, true); }
+        }
+    }
+    while(static_cast<int>(Scenarios.size()) < Count) {
+        const Position2D Start(rand() % mapWidth, rand() % mapHeight);
+        const Position2D Finish(rand() % mapWidth, rand() % mapHeight);
+        if(Map.isObstacle(Start.xPos, Start.yPos) || Map.isObstacle(Finish.xPos, Finish.yPos)) { continue; }
+        Scenarios.push_back(Scenario(0, "generated", Start, Finish, 0.0));
+    }
+}
+
+// directory of a file name, with the last slash
+string getDirectory(const string& FileName) {
+    const size_t slash = FileName.find_last_of("/\\");
+    return slash == string::npos ? "" : FileName.substr(0, slash + 1);
+}
+
+int main(int argc, char* argv[])
+{
+    string scenarioFile, mapFile, csvFile, modes = allModes;
+    int budget = 0; // microseconds per query of the anytime mode. 0: no limit
+    for(int i = 1; i < argc; ++i) {
+        const string argument = argv[i];
+        if(argument == "--csv" && i + 1 < argc) { csvFile = argv[++i]; }
+        else if(argument == "--modes" && i + 1 < argc) { modes = argv[++i]; }
+        else if(argument == "--budget" && i + 1 < argc) { budget = max(atoi(argv[++i]), 0); }
+        else if(scenarioFile.empty()) { scenarioFile = argument; }
+        else { mapFile = argument; }
+    }
+
+    GridMap map(0, 0);
+    vector<Scenario> scenarios;
+    string mapName = "generated";
+    if(scenarioFile.empty()) {
+        map = GridMap(256, 256);
+        generateScenarios(map, scenarios, 1000);
+    }
+    else {
+        scenarios = loadMovingAIScenarios(scenarioFile);
+        if(scenarios.empty()) {
+            cout << "No scenarios in " << scenarioFile << endl;
+            return 1;
+        }
+        mapName = mapFile.empty() ? scenarios.front().mapName : mapFile;
+        map = loadMovingAIMap(mapFile.empty() ? getDirectory(scenarioFile) + mapName : mapFile);
+        if(map.getSize() == 0) { map = loadMovingAIMap(mapName); } // the map path may be relative to the working directory
+        if(map.getSize() == 0) {
+            cout << "Can not read the map " << mapName << endl;
+            return 1;
+        }
+        // the scenarios out of the map can not be solved
+        scenarios.erase(remove_if(scenarios.begin(), scenarios.end(), [&](const Scenario& s) {
+            return !map.isInside(s.Start.xPos, s.Start.yPos) || !map.isInside(s.Finish.xPos, s.Finish.yPos);
+        }), scenarios.end());
+    }
+
+    // the optimal costs, and how they compare with the lengths of the .scen file
+    vector<int> optimalCosts;
+    PathFinder<OctileHeuristic> optimalFinder(map);
+    double lengthRatioSum = 0.0;
+    int lengthRatios = 0;
+    for(const Scenario& scenario : scenarios) {
+        const Route route = optimalFinder.findRoute(scenario.Start, scenario.Finish);
+        const bool found = !route.empty() || scenario.Start == scenario.Finish;
+        optimalCosts.push_back(found ? route.getCost() : -1);
+        if(found && scenario.optimalLength > 0.0) {
+            double length = 0.0;
+            for(const RouteRun& run : route.getRuns()) { length += run.count * (run.direction % 2 == 1 ? sqrt(2.0) : 1.0); }
+            lengthRatioSum += length / scenario.optimalLength;
+            ++lengthRatios;
+        }
+    }
+
+    cout << "Pathfinding benchmark suite. " << scenarios.size() << " scenarios on the " << map.getWidth() << "x" << map.getHeight()
+        << " map " << mapName << endl;
+    if(lengthRatios > 0) {
+        cout << "Optimal routes / .scen lengths (cutting corners): " << fixed << setprecision(4) << lengthRatioSum / lengthRatios
+            << endl;
+    }
+    cout << setw(14) << left << "Search" << right << setw(10) << "Setup ms" << setw(9) << "Solved" << setw(7) << "Fail"
+        << setw(12) << "Expansions" << setw(12) << "Heap ops" << setw(10) << "p50 us" << setw(10) << "p90 us" << setw(10)
+        << "p99 us" << setw(10) << "max us" << setw(11) << "Mean err" << setw(10) << "Max err" << endl;
+
+    ofstream csv;
+    if(!csvFile.empty()) {
+        csv.open(csvFile.c_str());
+        csv << "engine,mode,map,queries,solved,failures,setup_ms,expansions,heap_operations,time_p50_us,time_p90_us,time_p99_us,"
+            "time_max_us,mean_error,max_error" << endl;
+    }
+
+    stringstream modeList(modes);
+    string mode;
+    while(getline(modeList, mode, ',')) {
+        const ModeResult result = runMode(mode, map, scenarios, optimalCosts, budget);
+        if(result.queries == 0 && !scenarios.empty()) { continue; }
+        cout << setw(14) << left << result.mode << right << fixed << setprecision(2) << setw(10) << result.setupSeconds * 1000.0
+            << setw(9) << result.solved << setw(7) << result.failures << setw(12) << result.expansions << setw(12)
+            << result.heapOperations << setprecision(1) << setw(10) << result.percentile(50) << setw(10) << result.percentile(90)
+            << setw(10) << result.percentile(99) << setw(10) << result.percentile(100) << setprecision(4) << setw(11)
+            << result.meanError() << setw(10) << result.maxError << endl;
+        if(csv.is_open()) {
+            csv << "V2," << result.mode << "," << mapName << "," << result.queries << "," << result.solved << "," << result.failures
+                << "," << result.setupSeconds * 1000.0 << "," << result.expansions << "," << result.heapOperations << ","
+                << result.percentile(50) << "," << result.percentile(90) << "," << result.percentile(99) << ","
+                << result.percentile(100) << "," << result.meanError() << "," << result.maxError << endl;
+        }
+    }
+    return 0;
+}